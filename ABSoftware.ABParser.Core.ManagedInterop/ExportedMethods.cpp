@@ -1,4 +1,5 @@
 #include "ABParserBase.h"
+#include "ABParserPool.h"
 
 using namespace abparser;
 
@@ -11,7 +12,7 @@ using namespace abparser;
 #endif
 
 void Convert32BitTo16Bit(uint32_t bit32, uint16_t* out, uint32_t index) {
-	out[index] = bit32 << 16;
+	out[index] = bit32 >> 16;
 	out[index + 1] = bit32 & 0xffff;
 }
 
@@ -28,102 +29,195 @@ uint32_t MoveStringToArray(uint16_t* str, uint32_t strLen, uint16_t* data, uint3
 	return index;
 }
 
-class ConfigAndTokens {
-public:
-	ABParserConfiguration<uint16_t, uint16_t> Config;
-	ABParserToken<uint16_t, uint16_t>* Tokens;
+// The UTF-16 exports (used by the managed side) and the UTF-8 exports (suffixed with "UTF8") are the same, apart from the character type, so they all go through these.
+// Because we can't marshall three pointers for the "tokenLimitNames" (array of an array of limits) in, we need to push token limit names down into an array of strings.
+// Then, we have "numberOfTokenLimitsForToken", which represents how many limit names each token has. So, we can then convert that to "ABParserToken"s.
+// "tokenRunLengths" is the minimum and maximum length for each token, if there are any run tokens (otherwise it's null). For a run token, the minimum isn't 0, and its data is its ranges.
+template<typename T>
+ABParserConfiguration<T, T>* InitializeConfigurationFor(T** tokens, uint16_t* tokenLengths, uint32_t numberOfTokens, T** tokenLimitNames, uint8_t* tokenLimitNameSizes, uint16_t* numberOfTokenLimitsForToken, T** tokenDetectionLimits, uint16_t* tokenDetectionLimitSizes, uint32_t* tokenRunLengths) {
 
-	ConfigAndTokens(ABParserToken<uint16_t, uint16_t>* tokens, uint16_t numberOfTokens) {
-		Tokens = tokens;
-		Config.Init(tokens, numberOfTokens);
+	ABParserToken<T, T>* newTokens = new ABParserToken<T, T>[numberOfTokens];
+
+	uint32_t currentLimitNamesPos = 0;
+	for (uint32_t i = 0; i < numberOfTokens; i++) {
+		if (tokenRunLengths && tokenRunLengths[i * 2])
+			newTokens[i].SetRun(tokens[i], tokenLengths[i] / 2, tokenRunLengths[i * 2], tokenRunLengths[i * 2 + 1]);
+		else
+			newTokens[i].SetData(tokens[i], tokenLengths[i]);
+
+		newTokens[i].DirectSetDetectionLimit(tokenDetectionLimits[i], tokenDetectionLimitSizes[i]);
+		
+		uint16_t numberOfLimits = numberOfTokenLimitsForToken[i];
+		if (numberOfLimits) {
+			const std::basic_string<T>** newLimits = new const std::basic_string<T>*[numberOfLimits];
+
+			for (uint16_t j = 0; j < numberOfLimits; j++) {
+				newLimits[j] = new const std::basic_string<T>(tokenLimitNames[currentLimitNamesPos], tokenLimitNameSizes[currentLimitNamesPos]);
+				currentLimitNamesPos++;
+			}
+
+			newTokens[i].Limits = newLimits;
+			newTokens[i].LimitsLength = numberOfLimits;
+		}
 	}
+
+	// The configuration looks after the tokens from here, and is only deleted once it's been released by "DeleteConfiguration" and every parser using it.
+	ABParserConfiguration<T, T>* result = new ABParserConfiguration<T, T>(newTokens, numberOfTokens);
+	result->OwnsTokens = true;
+	return result;
+}
+
+// These two finish setting up a configuration, so they fail (returning false) once any parser's using it - everything sharing a configuration relies on it not changing.
+template<typename T>
+uint32_t ConfigSetTriviaLimitsFor(ABParserConfiguration<T, T>* information, uint32_t* limitIsWhiteList, T** limitNames, uint8_t* limitNameLengths, T** limitContents, uint16_t* limitContentLengths, uint16_t numberOfLimits) {
+	if (information->IsShared()) return false;
 	
-	~ConfigAndTokens() {
-		delete[] Tokens;
+	information->TriviaLimits.reserve(numberOfLimits);
+
+	for (uint16_t i = 0; i < numberOfLimits; i++) {
+
+		TriviaLimit<T>* limit = new TriviaLimit<T>(); 
+		limit->DirectSetData(limitContents[i], limitContentLengths[i]);
+		limit->SetIsWhitelist(limitIsWhiteList[i]);
+
+		std::basic_string<T> currentLimitName(limitNames[i], limitNameLengths[i]);
+		information->TriviaLimits.emplace(std::move(currentLimitName), limit);
 	}
-};
 
-extern "C" {
-	// Because we can't marshall three pointers for the "tokenLimitNames" (array of an array of limits) in, we need to push token limit names down into an array of strings.
-	// Then, we have "numberOfTokenLimitsForToken", which represents how many limit names each token has. So, we can then convert that to "ABParserToken"s.
-	EXPORT ConfigAndTokens* InitializeConfiguration(uint16_t** tokens, uint16_t* tokenLengths, uint16_t numberOfTokens, uint16_t** tokenLimitNames, uint8_t* tokenLimitNameSizes, uint16_t* numberOfTokenLimitsForToken, uint16_t** tokenDetectionLimits, uint16_t* tokenDetectionLimitSizes) {
+	// Any limit rules can only find these now they're here.
+	information->ResolveLimitRules();
+	return true;
+}
 
-		ABParserToken<uint16_t, uint16_t>* newTokens = new ABParserToken<uint16_t, uint16_t>[numberOfTokens];
+// Every token has four names here, in the order: enters token limit, exits token limit, enters trivia limit, exits trivia limit. A size of 0 means the token doesn't have that rule.
+template<typename T>
+uint32_t ConfigSetLimitRulesFor(ABParserConfiguration<T, T>* information, T** ruleNames, uint8_t* ruleNameSizes) {
+	if (information->IsShared()) return false;
+	uint32_t numberOfTokens = information->NumberOfTokens;
 
-		uint16_t currentLimitNamesPos = 0;
-		for (uint16_t i = 0; i < numberOfTokens; i++) {
-			newTokens[i].SetData(tokens[i], tokenLengths[i]);
-			newTokens[i].DirectSetDetectionLimit(tokenDetectionLimits[i], tokenDetectionLimitSizes[i]);
-			
-			uint16_t numberOfLimits = numberOfTokenLimitsForToken[i];
-			if (numberOfLimits) {
-				const std::basic_string<uint16_t>** newLimits = new const std::basic_string<uint16_t>*[numberOfLimits];
-
-				for (uint16_t j = 0; j < numberOfLimits; j++) {
-					newLimits[j] = new const std::basic_string<uint16_t>(tokenLimitNames[currentLimitNamesPos], tokenLimitNameSizes[currentLimitNamesPos]);
-					currentLimitNamesPos++;
-				}
-
-				newTokens[i].Limits = newLimits;
-				newTokens[i].LimitsLength = numberOfLimits;
-			}
-		}
+	for (uint32_t i = 0; i < numberOfTokens; i++) {
+		ABParserToken<T, T>& token = information->Tokens[i];
+		uint32_t first = (uint32_t)i * 4;
 
-		ConfigAndTokens* result = new ConfigAndTokens(newTokens, numberOfTokens);
-		return result;
+		if (ruleNameSizes[first]) token.SetEntersTokenLimit(std::basic_string<T>(ruleNames[first], ruleNameSizes[first]));
+		if (ruleNameSizes[first + 1]) token.SetExitsTokenLimit(std::basic_string<T>(ruleNames[first + 1], ruleNameSizes[first + 1]));
+		if (ruleNameSizes[first + 2]) token.SetEntersTriviaLimit(std::basic_string<T>(ruleNames[first + 2], ruleNameSizes[first + 2]));
+		if (ruleNameSizes[first + 3]) token.SetExitsTriviaLimit(std::basic_string<T>(ruleNames[first + 3], ruleNameSizes[first + 3]));
 	}
 
-	EXPORT void ConfigSetTriviaLimits(ConfigAndTokens* information, uint32_t* limitIsWhiteList, uint16_t** limitNames, uint8_t* limitNameLengths, uint16_t** limitContents, uint16_t* limitContentLengths, uint16_t numberOfLimits) {
-		
-		information->Config.TriviaLimits.reserve(numberOfLimits);
+	information->ResolveLimitRules();
+	return true;
+}
 
-		for (uint16_t i = 0; i < numberOfLimits; i++) {
+template<typename T>
+uint32_t EnterTokenLimitFor(ABParserBase<T, T>* parser, T* limitName, uint8_t limitNameLength) {
+	std::basic_string<T> asStr(limitName, limitNameLength);
+	return parser->EnterTokenLimit(asStr);
+}
 
-			TriviaLimit<uint16_t>* limit = new TriviaLimit<uint16_t>(); 
-			limit->DirectSetData(limitContents[i], limitContentLengths[i]);
-			limit->SetIsWhitelist(limitIsWhiteList[i]);
+template<typename T>
+void ExitTokenLimitFor(ABParserBase<T, T>* parser, int levels) {
+	for (int i = 0; i < levels; i++)
+		parser->ExitTokenLimit();
+}
 
-			std::basic_string<uint16_t> currentLimitName(limitNames[i], limitNameLengths[i]);
-			information->Config.TriviaLimits.emplace(std::move(currentLimitName), limit);
-		}
+template<typename T>
+uint32_t EnterTriviaLimitFor(ABParserBase<T, T>* parser, T* limitName, uint8_t limitNameLength) {
+	std::basic_string<T> asStr(limitName, limitNameLength);
+	return parser->EnterTriviaLimit(asStr);
+}
+
+template<typename T>
+void ExitTriviaLimitFor(ABParserBase<T, T>* parser, int levels) {
+	for (int i = 0; i < levels; i++)
+		parser->ExitTriviaLimit();
+}
+
+// A null "mask" subscribes to every token again.
+template<typename T>
+void SetTokenSubscriptionsFor(ABParserBase<T, T>* parser, uint64_t* mask, uint32_t maskLength, ABParserUnsubscribedTokens unsubscribedTokens) {
+	parser->UnsubscribedTokens = unsubscribedTokens;
+
+	if (mask) parser->SetTokenSubscriptions(mask, maskLength);
+	else parser->SubscribeToAllTokens();
+}
+
+extern "C" {
+	EXPORT ABParserConfiguration<uint16_t, uint16_t>* InitializeConfiguration(uint16_t** tokens, uint16_t* tokenLengths, uint32_t numberOfTokens, uint16_t** tokenLimitNames, uint8_t* tokenLimitNameSizes, uint16_t* numberOfTokenLimitsForToken, uint16_t** tokenDetectionLimits, uint16_t* tokenDetectionLimitSizes, uint32_t* tokenRunLengths) {
+		return InitializeConfigurationFor(tokens, tokenLengths, numberOfTokens, tokenLimitNames, tokenLimitNameSizes, numberOfTokenLimitsForToken, tokenDetectionLimits, tokenDetectionLimitSizes, tokenRunLengths);
 	}
 
-	EXPORT ABParserBase<uint16_t, uint16_t>* CreateBaseParser(ConfigAndTokens* information) {
-		return new ABParserBase<uint16_t, uint16_t>(&information->Config);
+	EXPORT uint32_t ConfigSetTriviaLimits(ABParserConfiguration<uint16_t, uint16_t>* information, uint32_t* limitIsWhiteList, uint16_t** limitNames, uint8_t* limitNameLengths, uint16_t** limitContents, uint16_t* limitContentLengths, uint16_t numberOfLimits) {
+		return ConfigSetTriviaLimitsFor(information, limitIsWhiteList, limitNames, limitNameLengths, limitContents, limitContentLengths, numberOfLimits);
+	}
+
+	EXPORT uint32_t ConfigSetLimitRules(ABParserConfiguration<uint16_t, uint16_t>* information, uint16_t** ruleNames, uint8_t* ruleNameSizes) {
+		return ConfigSetLimitRulesFor(information, ruleNames, ruleNameSizes);
+	}
+
+	EXPORT ABParserBase<uint16_t, uint16_t>* CreateBaseParser(ABParserConfiguration<uint16_t, uint16_t>* information) {
+		return new ABParserBase<uint16_t, uint16_t>(information);
 	}
 
 	EXPORT void DeleteBaseParser(ABParserBase<uint16_t, uint16_t>* parser) {
 		delete parser;
 	}
 
-	EXPORT void DeleteConfiguration(ConfigAndTokens* parser) {
-		delete parser;
+	// Any parsers still using the configuration keep it alive, so this can be called at any point.
+	EXPORT void DeleteConfiguration(ABParserConfiguration<uint16_t, uint16_t>* configuration) {
+		configuration->Release();
+	}
+
+	// Parsers from a pool must be given back with "ReleasePooledParser", not deleted.
+	EXPORT ABParserPool<uint16_t, uint16_t>* CreateParserPool(ABParserConfiguration<uint16_t, uint16_t>* configuration) {
+		return new ABParserPool<uint16_t, uint16_t>(configuration);
+	}
+
+	EXPORT ABParserBase<uint16_t, uint16_t>* AcquirePooledParser(ABParserPool<uint16_t, uint16_t>* pool) {
+		return pool->Acquire();
+	}
+
+	EXPORT void ReleasePooledParser(ABParserPool<uint16_t, uint16_t>* pool, ABParserBase<uint16_t, uint16_t>* parser) {
+		pool->Release(parser);
+	}
+
+	EXPORT void DeleteParserPool(ABParserPool<uint16_t, uint16_t>* pool) {
+		delete pool;
 	}
 
 	EXPORT uint32_t EnterTokenLimit(ABParserBase<uint16_t, uint16_t>* parser, uint16_t* limitName, uint8_t limitNameLength) {
-		std::basic_string<uint16_t> asStr(limitName, limitNameLength);
-		return parser->EnterTokenLimit(asStr);
+		return EnterTokenLimitFor(parser, limitName, limitNameLength);
 	}
 
 	EXPORT void ExitTokenLimit(ABParserBase<uint16_t, uint16_t>* parser, int levels) {
-		for (int i = 0; i < levels; i++)
-			parser->ExitTokenLimit();
+		ExitTokenLimitFor(parser, levels);
 	}
 
 	EXPORT uint32_t EnterTriviaLimit(ABParserBase<uint16_t, uint16_t>* parser, uint16_t* limitName, uint8_t limitNameLength) {
-		std::basic_string<uint16_t> asStr(limitName, limitNameLength);
-		return parser->EnterTriviaLimit(asStr);
+		return EnterTriviaLimitFor(parser, limitName, limitNameLength);
 	}
 
 	EXPORT void ExitTriviaLimit(ABParserBase<uint16_t, uint16_t>* parser, int levels) {
-		for (int i = 0; i < levels; i++)
-			parser->ExitTriviaLimit();
+		ExitTriviaLimitFor(parser, levels);
+	}
+
+	EXPORT void SetTokenSubscriptions(ABParserBase<uint16_t, uint16_t>* parser, uint64_t* mask, uint32_t maskLength, ABParserUnsubscribedTokens unsubscribedTokens) {
+		SetTokenSubscriptionsFor(parser, mask, maskLength, unsubscribedTokens);
+	}
+
+	// The managed side handles deadlines and cancellation itself, in between the yields this gives it.
+	EXPORT void SetCharacterBudget(ABParserBase<uint16_t, uint16_t>* parser, uint32_t characterBudget) {
+		parser->CharacterBudget = characterBudget;
+	}
+
+	EXPORT void ResetParseState(ABParserBase<uint16_t, uint16_t>* parser) {
+		parser->ResetParseState();
 	}
 
 	EXPORT ABParserResult ContinueExecution(ABParserBase<uint16_t, uint16_t>* parser, uint16_t* outData) {
 		ABParserResult result = parser->ContinueExecution();
 
-		if (result == ABParserResult::None) return result;
+		if (result == ABParserResult::None || result == ABParserResult::Yielded) return result;
 
 		// SEE ABSOFTWARE DOCS:
 		// Send all of the extra data that's associated with this event.
@@ -135,13 +229,13 @@ extern "C" {
 
 		// Token
 		if (result != ABParserResult::StopAndFinalOnTokenProcessed) {
-			outData[0] = parser->CurrentEventToken->MixedIdx;
-			Convert32BitTo16Bit(parser->CurrentEventTokenStart, outData, 1);
-			Convert32BitTo16Bit((parser->CurrentEventTokenStart + parser->CurrentEventTokenLengthInText) - 1, outData, 3);
+			Convert32BitTo16Bit(parser->CurrentEventToken->MixedIdx, outData, 0);
+			Convert32BitTo16Bit(parser->CurrentEventTokenStart, outData, 2);
+			Convert32BitTo16Bit((parser->CurrentEventTokenStart + parser->CurrentEventTokenLengthInText) - 1, outData, 4);
 		}
 
 		// Trivia
-		MoveStringToArray(parser->CurrentTrivia, parser->CurrentTriviaLength, outData, 5);
+		MoveStringToArray(parser->CurrentTrivia, parser->CurrentTriviaLength, outData, 6);
 		return result;
 	}
 
@@ -149,7 +243,163 @@ extern "C" {
 		parser->InitString(text, textLength);
 	}
 
+	// The buffer is pinned on the managed side for the whole batch. Returns false (without starting it) if the offsets aren't valid.
+	EXPORT uint32_t BeginBatch(ABParserBase<uint16_t, uint16_t>* parser, uint16_t* buffer, uint32_t bufferLength, uint32_t* offsets, uint32_t numberOfRecords) {
+		if (!ABParserBase<uint16_t, uint16_t>::IsValidBatch(bufferLength, offsets, numberOfRecords)) return false;
+
+		parser->BeginBatch(buffer, bufferLength, offsets, numberOfRecords);
+		return true;
+	}
+
+	// Works just like "ContinueExecution", except it moves onto the next record once the last one stopped - "None" means the whole batch is finished.
+	EXPORT ABParserResult ContinueBatchExecution(ABParserBase<uint16_t, uint16_t>* parser, uint16_t* outData) {
+		if (parser->IsBetweenRecords() && !parser->NextRecord()) return ABParserResult::None;
+		return ContinueExecution(parser, outData);
+	}
+
 	EXPORT void DisposeDataForNextParse(ABParserBase<uint16_t>* parser) {
 		parser->DisposeDataForNextParse();
 	}
+
+	// The statistics are only collected if the core was compiled with "_ABP_COLLECT_STATS", otherwise this will just give zeros.
+	EXPORT void GetStatistics(ABParserBase<uint16_t, uint16_t>* parser, ABParserStatistics* outStatistics) {
+		*outStatistics = parser->Statistics;
+	}
+
+	EXPORT void ResetStatistics(ABParserBase<uint16_t, uint16_t>* parser) {
+		parser->ResetStatistics();
+	}
+
+	// UTF-8:
+	// These work exactly like the ones above, but take UTF-8 text, tokens and limits directly, so there's no need to convert a whole document to UTF-16 first.
+	// All of the positions given back are byte offsets - "GetCodePointOffsetUTF8" can turn them into code point offsets where they're needed.
+	EXPORT ABParserConfiguration<char, char>* InitializeConfigurationUTF8(char** tokens, uint16_t* tokenLengths, uint32_t numberOfTokens, char** tokenLimitNames, uint8_t* tokenLimitNameSizes, uint16_t* numberOfTokenLimitsForToken, char** tokenDetectionLimits, uint16_t* tokenDetectionLimitSizes, uint32_t* tokenRunLengths) {
+		ABParserConfiguration<char, char>* result = InitializeConfigurationFor(tokens, tokenLengths, numberOfTokens, tokenLimitNames, tokenLimitNameSizes, numberOfTokenLimitsForToken, tokenDetectionLimits, tokenDetectionLimitSizes, tokenRunLengths);
+		result->IsUTF8 = true;
+		return result;
+	}
+
+	EXPORT uint32_t ConfigSetTriviaLimitsUTF8(ABParserConfiguration<char, char>* information, uint32_t* limitIsWhiteList, char** limitNames, uint8_t* limitNameLengths, char** limitContents, uint16_t* limitContentLengths, uint16_t numberOfLimits) {
+		return ConfigSetTriviaLimitsFor(information, limitIsWhiteList, limitNames, limitNameLengths, limitContents, limitContentLengths, numberOfLimits);
+	}
+
+	EXPORT uint32_t ConfigSetLimitRulesUTF8(ABParserConfiguration<char, char>* information, char** ruleNames, uint8_t* ruleNameSizes) {
+		return ConfigSetLimitRulesFor(information, ruleNames, ruleNameSizes);
+	}
+
+	EXPORT ABParserBase<char, char>* CreateBaseParserUTF8(ABParserConfiguration<char, char>* information) {
+		return new ABParserBase<char, char>(information);
+	}
+
+	EXPORT void DeleteBaseParserUTF8(ABParserBase<char, char>* parser) {
+		delete parser;
+	}
+
+	EXPORT void DeleteConfigurationUTF8(ABParserConfiguration<char, char>* configuration) {
+		configuration->Release();
+	}
+
+	EXPORT ABParserPool<char, char>* CreateParserPoolUTF8(ABParserConfiguration<char, char>* configuration) {
+		return new ABParserPool<char, char>(configuration);
+	}
+
+	EXPORT ABParserBase<char, char>* AcquirePooledParserUTF8(ABParserPool<char, char>* pool) {
+		return pool->Acquire();
+	}
+
+	EXPORT void ReleasePooledParserUTF8(ABParserPool<char, char>* pool, ABParserBase<char, char>* parser) {
+		pool->Release(parser);
+	}
+
+	EXPORT void DeleteParserPoolUTF8(ABParserPool<char, char>* pool) {
+		delete pool;
+	}
+
+	EXPORT uint32_t EnterTokenLimitUTF8(ABParserBase<char, char>* parser, char* limitName, uint8_t limitNameLength) {
+		return EnterTokenLimitFor(parser, limitName, limitNameLength);
+	}
+
+	EXPORT void ExitTokenLimitUTF8(ABParserBase<char, char>* parser, int levels) {
+		ExitTokenLimitFor(parser, levels);
+	}
+
+	EXPORT uint32_t EnterTriviaLimitUTF8(ABParserBase<char, char>* parser, char* limitName, uint8_t limitNameLength) {
+		return EnterTriviaLimitFor(parser, limitName, limitNameLength);
+	}
+
+	EXPORT void ExitTriviaLimitUTF8(ABParserBase<char, char>* parser, int levels) {
+		ExitTriviaLimitFor(parser, levels);
+	}
+
+	EXPORT void SetTokenSubscriptionsUTF8(ABParserBase<char, char>* parser, uint64_t* mask, uint32_t maskLength, ABParserUnsubscribedTokens unsubscribedTokens) {
+		SetTokenSubscriptionsFor(parser, mask, maskLength, unsubscribedTokens);
+	}
+
+	EXPORT void SetCharacterBudgetUTF8(ABParserBase<char, char>* parser, uint32_t characterBudget) {
+		parser->CharacterBudget = characterBudget;
+	}
+
+	EXPORT void ResetParseStateUTF8(ABParserBase<char, char>* parser) {
+		parser->ResetParseState();
+	}
+
+	// SEE ABSOFTWARE DOCS:
+	// Unlike the UTF-16 version, the numbers are given back as full 32-bit values in "outData" - [0] is the token's index, [1] and [2] are where it starts and ends (in bytes), and [3] is the length of the trivia.
+	// The trivia itself is copied into "outTrivia", which must be as big as the text. For "OnFirstUnlimitedCharacterProcessed", [0] is just the position.
+	EXPORT ABParserResult ContinueExecutionUTF8(ABParserBase<char, char>* parser, uint32_t* outData, char* outTrivia) {
+		ABParserResult result = parser->ContinueExecution();
+
+		if (result == ABParserResult::None || result == ABParserResult::Yielded) return result;
+
+		if (result == ABParserResult::OnFirstUnlimitedCharacterProcessed) {
+			outData[0] = parser->InternalPosition;
+			return result;
+		}
+
+		// Token
+		if (result != ABParserResult::StopAndFinalOnTokenProcessed) {
+			outData[0] = parser->CurrentEventToken->MixedIdx;
+			outData[1] = parser->CurrentEventTokenStart;
+			outData[2] = (parser->CurrentEventTokenStart + parser->CurrentEventTokenLengthInText) - 1;
+		}
+
+		// Trivia
+		outData[3] = parser->CurrentTriviaLength;
+		for (uint32_t i = 0; i < parser->CurrentTriviaLength; i++)
+			outTrivia[i] = parser->CurrentTrivia[i];
+
+		return result;
+	}
+
+	EXPORT void InitStringUTF8(ABParserBase<char, char>* parser, char* text, int textLength) {
+		parser->InitString(text, textLength);
+	}
+
+	EXPORT uint32_t BeginBatchUTF8(ABParserBase<char, char>* parser, char* buffer, uint32_t bufferLength, uint32_t* offsets, uint32_t numberOfRecords) {
+		if (!ABParserBase<char, char>::IsValidBatch(bufferLength, offsets, numberOfRecords)) return false;
+
+		parser->BeginBatch(buffer, bufferLength, offsets, numberOfRecords);
+		return true;
+	}
+
+	EXPORT ABParserResult ContinueBatchExecutionUTF8(ABParserBase<char, char>* parser, uint32_t* outData, char* outTrivia) {
+		if (parser->IsBetweenRecords() && !parser->NextRecord()) return ABParserResult::None;
+		return ContinueExecutionUTF8(parser, outData, outTrivia);
+	}
+
+	EXPORT void DisposeDataForNextParseUTF8(ABParserBase<char, char>* parser) {
+		parser->DisposeDataForNextParse();
+	}
+
+	EXPORT uint32_t GetCodePointOffsetUTF8(ABParserBase<char, char>* parser, uint32_t position) {
+		return parser->GetCodePointOffset(position);
+	}
+
+	EXPORT void GetStatisticsUTF8(ABParserBase<char, char>* parser, ABParserStatistics* outStatistics) {
+		*outStatistics = parser->Statistics;
+	}
+
+	EXPORT void ResetStatisticsUTF8(ABParserBase<char, char>* parser) {
+		parser->ResetStatistics();
+	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef _ABPARSER_INCLUDE_ABPARSER_H
 #define _ABPARSER_INCLUDE_ABPARSER_H
 #include "ABParserBase.h"
+#include "ABParserTokenStream.h"
+#include "ABParserPipeline.h"
 
 namespace abparser {
 	template<typename T, typename U = char>
@@ -47,8 +49,13 @@ namespace abparser {
 
 			Trailing = trailing;
 			TrailingLength = trailingLength;
+
+			TrailingKnown = true;
 		}
 
+		// Only false when the token's being given early (see "ABParser::EmitTokensEarly") - there's no trailing or next token yet, they come later in "OnTrailingProcessed".
+		bool TrailingKnown;
+
 		const std::basic_string<T>* GetTrailingAsString() const { return new const std::basic_string<T>(Trailing, TrailingLength); }
 	};
 
@@ -56,29 +63,31 @@ namespace abparser {
 	class ABParser {
 	public:
 		ABParserBase<T, U> Base;
-		ABParserToken<T, U>* Tokens;
 		T* Leading;
 		uint32_t LeadingLength;
 
-		ABParser(ABParserConfiguration<T, U>* configuration, ABParserToken<T, U>* tokens) {
+		// If this is set, "OnTokenProcessed" is triggered for every token as soon as it's found (straight after its "BeforeTokenProcessed"), rather than waiting for the next token to be found
+		// so it can have its trailing. The trailing is given afterwards instead, in "OnTrailingProcessed", once it's known. This is for when a token needs to be acted on as soon as possible.
+		bool EmitTokensEarly;
+
+		// The tokens come from the configuration, which this parser holds a reference to, so they'll always be there for as long as the parser is.
+		ABParser(ABParserConfiguration<T, U>* configuration) {
 			Base.InitConfiguration(configuration);
-			Tokens = tokens;
 
 			Leading = nullptr;
 			LeadingLength = 0;
+			EmitTokensEarly = false;
+			pipelined = false;
 		}
 
-		void SetText(T* text, uint32_t textLength) {
-
-			// Reallocate the "Leading", if it isn't big enough to contain our new text.
-			if (Base.TextLength < textLength) {
-				if (Leading != nullptr)
-					delete[] Leading;
-
-				Leading = new T[(size_t)textLength + 1];
-			}
+		virtual ~ABParser() {
+			delete[] Leading;
+		}
 
+		void SetText(T* text, uint32_t textLength) {
+			uint32_t oldCapacity = Base.TriviaCapacity;
 			Base.InitString(text, textLength);
+			UpdateLeadingCapacity(oldCapacity);
 		}
 
 		void SetText(const T* text, uint32_t textLength) {
@@ -89,10 +98,161 @@ namespace abparser {
 			SetText((T*)text.c_str(), (uint32_t)text.size());
 		}
 
-		void Start() {
+		// Any yields from the base's budget are just carried on through, but if it's cancelled or runs past its deadline (see "ABParserBase::CharacterBudget"), the parse is abandoned part-way
+		// through, without "OnEnd". Returns whether it finished.
+		bool Start() {
+			return Run(nullptr, nullptr, nullptr);
+		}
+
+		// Parses every record in a batch (see "ABParserBase::BeginBatch"), all in one go. Each record is parsed separately, with everything (including any limits) reset in between, but "OnStart"
+		// and "OnEnd" are only triggered once, around the whole batch (with "OnEnd" given no leading) - each record finishes with "OnRecordEnd" instead. "Base.CurrentRecord" says which record
+		// the events are for, and all of the positions they're given are within that record. Returns whether it finished, like "Start".
+		bool StartBatch(const T* buffer, uint32_t bufferLength, const uint32_t* offsets, uint32_t numberOfRecords) {
+			uint32_t oldCapacity = Base.TriviaCapacity;
+			Base.BeginBatch(buffer, bufferLength, offsets, numberOfRecords);
+			UpdateLeadingCapacity(oldCapacity);
+
+			OnStart();
+			AllocateTriviaBuffers();
+
+			T* endTrivia;
+			uint32_t endTriviaLength;
+
+			while (Base.NextRecord()) {
+				if (!RunEvents(nullptr, nullptr, nullptr, endTrivia, endTriviaLength)) return false;
+				OnRecordEnd(Base.CurrentRecord, endTrivia, endTriviaLength);
+			}
+
+			Base.DisposeDataForNextParse();
+			OnEnd(nullptr, 0);
+			return true;
+		}
+
+		// Runs the parse without triggering any of the events, writing all of the tokens into a token stream instead - see "ABParserTokenStream.h".
+		bool Start(ABParserTokenStreamWriter& writer) {
+			return writer.WriteParse(&Base);
+		}
+
+		// Runs the parse like "Start" (with all of the events), but also records the tokens into a token stream as they're found.
+		bool StartRecording(ABParserTokenStreamWriter& recorder) {
+			return Run(&recorder, nullptr, nullptr);
+		}
+
+		// Triggers all of the events from a token stream that was recorded for this same text, without actually parsing anything.
+		// The trivia is rebuilt from the text, so this can't reproduce trivia limits.
+		void StartReplaying(ABParserTokenStreamReader& replay) {
+			Run(nullptr, &replay, nullptr);
+		}
+
+		// Runs the parse on another thread, with the events still triggered on this one as the tokens come through a queue (of "queueCapacity" results), so slow events don't hold up the parsing.
+		// The parse is ahead of the events, so they can't enter or exit any limits themselves - the limit methods here throw if they try, and the base's mustn't be used. Configurations with
+		// limits only get pipelined if their tokens have limit rules to do that instead (see "ABParserToken::SetEntersTokenLimit"), otherwise they just run like "Start". Returns whether it was
+		// actually pipelined. Neither do parsers that skip unsubscribed tokens, as the queue can only say where the trivia is, not what's been left out of it.
+		// Any trivia without a limit is given straight from the text, so the events can't change the text while this runs. If the parse is cancelled or runs past its deadline, the events just stop.
+		bool StartPipelined(size_t queueCapacity = 1024) {
+			ABParserConfiguration<T, U>* configuration = Base.Configuration;
+			bool skipsTokens = Base.HasUnsubscribedTokens() && Base.UnsubscribedTokens == ABParserUnsubscribedTokens::Skip;
+
+			if (skipsTokens || (!configuration->HasLimitRules && (!configuration->TokenLimits.empty() || !configuration->TriviaLimits.empty()))) {
+				Start();
+				return false;
+			}
+
+			AllocateTriviaBuffers();
+
+			ABParserEventQueue<ABParserEventRecord<T>> queue(queueCapacity);
+			std::atomic<bool> cancelled(false);
+
+			// The parsing thread only needs to say where the trivia is, not copy it.
+			bool locateOnly = Base.LocateOnly;
+			Base.LocateOnly = true;
+
+			std::thread producer([&]() { Produce(queue, cancelled, !locateOnly); });
+			pipelined = true;
+
+			try {
+				Run(nullptr, nullptr, &queue);
+			} catch (...) {
+				cancelled.store(true, std::memory_order_release);
+				producer.join();
+				pipelined = false;
+				Base.LocateOnly = locateOnly;
+				throw;
+			}
+
+			producer.join();
+			pipelined = false;
+			Base.LocateOnly = locateOnly;
+			return true;
+		}
+
+		// These can't be used by the events of a pipelined parse (see "StartPipelined"), and throw if they are.
+		bool EnterTokenLimit(const U* limitName, uint8_t limitNameSize) { return EnterTokenLimit(std::basic_string<U>(limitName, limitNameSize)); }
+		bool EnterTokenLimit(const std::basic_string<U>& limitName) {
+			CheckLimitsCanChange();
+			return Base.EnterTokenLimit(limitName);
+		}
+
+		void ExitTokenLimit() {
+			CheckLimitsCanChange();
+			Base.ExitTokenLimit();
+		}
+
+		bool EnterTriviaLimit(const U* limitName, uint8_t limitNameSize) { return EnterTriviaLimit(std::basic_string<U>(limitName, limitNameSize)); }
+		bool EnterTriviaLimit(const std::basic_string<U>& limitName) {
+			CheckLimitsCanChange();
+			return Base.EnterTriviaLimit(limitName);
+		}
+
+		void ExitTriviaLimit() {
+			CheckLimitsCanChange();
+			Base.ExitTriviaLimit();
+		}
+
+		virtual void OnStart() {}
+		virtual void OnEnd(T* leading, uint32_t leadingLength) {}
+		virtual void OnRecordEnd(uint32_t record, T* leading, uint32_t leadingLength) {}
+		virtual void BeforeTokenProcessed(const BeforeTokenProcessedArgs<T, U>& args) {}
+		virtual void OnTokenProcessed(const OnTokenProcessedArgs<T, U>& args) {}
+		virtual void OnTrailingProcessed(const OnTokenProcessedArgs<T, U>& args) {}
+		virtual void OnFirstUnlimitedCharacterProcessed(uint32_t pos) {}
+
+		// When "Base.MaxTriviaLength" is set, trivia longer than that isn't copied. If there's no trivia limit, the events just get given it straight from the text,
+		// but otherwise it has to be filtered, so it comes through here instead, a piece at a time (just before the event it would've been given to), and the events get empty trivia.
+		// "kind" says whether it's the leading of the first token, the trivia between two tokens, or the trailing of the last one.
+		virtual void OnTriviaChunk(const T* chunk, uint32_t chunkLength, ABParserTriviaChunkKind kind) {}
+
+	private:
+		// Whether the events are currently coming from a pipelined parse, on another thread.
+		bool pipelined;
+
+		void CheckLimitsCanChange() {
+			if (pipelined) throw "Limits can't be entered or exited by the events of a pipelined parse, give the tokens limit rules instead.";
+		}
+
+		bool Run(ABParserTokenStreamWriter* recorder, ABParserTokenStreamReader* replay, ABParserEventQueue<ABParserEventRecord<T>>* pipeline) {
 
 			OnStart();
+			if (recorder) recorder->Begin();
+
+			// (When pipelined, this already happened before the parsing thread started)
+			if (!pipeline) AllocateTriviaBuffers();
+
+			T* endTrivia;
+			uint32_t endTriviaLength;
+			if (!RunEvents(recorder, replay, pipeline, endTrivia, endTriviaLength)) return false;
+
+			if (recorder) recorder->End(Base.TextLength);
 
+			// When replaying, the base never ran, so anything the events did to it (like entering limits) still needs to be undone.
+			if (replay) Base.ResetParseState();
+
+			OnEnd(endTrivia, endTriviaLength);
+			return true;
+		}
+
+		// Triggers the events for one whole text, giving back what's left at the end of it.
+		bool RunEvents(ABParserTokenStreamWriter* recorder, ABParserTokenStreamReader* replay, ABParserEventQueue<ABParserEventRecord<T>>* pipeline, T*& endTrivia, uint32_t& endTriviaLength) {
 			TokenInformation<T, U>* swap;
 
 			TokenInformation<T, U> infoStorage[3];
@@ -102,41 +262,91 @@ namespace abparser {
 
 			ABParserResult result = ABParserResult::None;
 			bool firstOTP = true;
+			bool hasToken = false;
+			bool replayStarted = false;
+			ABParserEventRecord<T> record;
+
+			// What the events actually get given as the trivia - usually the buffers, but it can point straight into the text if the trivia was too long to copy.
+			T* trivia = nullptr;
+			uint32_t triviaLength = 0;
+			T* leading = nullptr;
 
 			while (result != ABParserResult::StopAndFinalOnTokenProcessed) {
 
-				// Swap the Leading with the CurrentTrivia.
+				// Swap the Leading with the CurrentTrivia. When pipelined, the base is only locating tokens, so it never touches its trivia buffer, and this thread can use it.
 				T* triviaSwap = Leading;
 				Leading = Base.CurrentTrivia;
 				Base.CurrentTrivia = triviaSwap;
+				leading = trivia;
+				LeadingLength = triviaLength;
 
-				result = Base.ContinueExecution();
+				if (replay) result = ReplayNext(replay, replayStarted, hasToken);
+				else if (pipeline) result = PipelineNext(pipeline, record, hasToken);
+				else result = ContinueBase();
+
+				// The parse was cancelled or ran out of time (when pipelined, the parsing thread has already abandoned it).
+				if (result == ABParserResult::Yielded) {
+					if (!pipeline) Base.ResetParseState();
+					return false;
+				}
 
 				if (result == ABParserResult::OnFirstUnlimitedCharacterProcessed) {
-					OnFirstUnlimitedCharacterProcessed(Base.InternalPosition);
+					OnFirstUnlimitedCharacterProcessed(replay ? 0 : pipeline ? record.TriviaStart : Base.InternalPosition);
 					continue;
 				}
 
+				if (!replay && !pipeline) hasToken = Base.CurrentEventToken != nullptr;
+
+				// If there weren't any tokens in the text at all, there's nothing to give.
+				if (!hasToken)
+					continue;
+
+				ABParserTriviaChunkKind triviaKind = result == ABParserResult::FirstBeforeTokenProcessed ? ABParserTriviaChunkKind::Leading :
+					result == ABParserResult::StopAndFinalOnTokenProcessed ? ABParserTriviaChunkKind::Trailing : ABParserTriviaChunkKind::Between;
+
+				if (pipeline) PrepareTriviaFromText(record.TriviaStart, record.TriviaLength, record.ActiveTriviaLimit, nullptr, triviaKind, trivia, triviaLength);
+				else PrepareTrivia(triviaKind, trivia, triviaLength);
+
 				swap = otpPreviousToken;
 				otpPreviousToken = otpToken;
 				otpToken = otpNextToken;
 				otpNextToken = swap;
 
-				otpNextToken->Token = &Tokens[Base.CurrentEventToken->MixedIdx];
-				otpNextToken->Start = Base.CurrentEventTokenStart;
-				otpNextToken->Length = Base.CurrentEventTokenLengthInText;
+				if (result != ABParserResult::StopAndFinalOnTokenProcessed) {
+					if (replay) {
+						otpNextToken->Token = &Base.Configuration->Tokens[replay->TokenIndex];
+						otpNextToken->Start = replay->TokenStart;
+						otpNextToken->Length = replay->TokenLength;
+					} else if (pipeline) {
+						otpNextToken->Token = &Base.Configuration->Tokens[record.TokenIndex];
+						otpNextToken->Start = record.TokenStart;
+						otpNextToken->Length = record.TokenLength;
+					} else {
+						otpNextToken->Token = &Base.Configuration->Tokens[Base.CurrentEventToken->MixedIdx];
+						otpNextToken->Start = Base.CurrentEventTokenStart;
+						otpNextToken->Length = Base.CurrentEventTokenLengthInText;
+					}
+
+					if (recorder) recorder->WriteToken((uint32_t)(otpNextToken->Token - Base.Configuration->Tokens), otpNextToken->Start, otpNextToken->Length);
+				}
 
 				switch (result) {
 				case ABParserResult::FirstBeforeTokenProcessed:
 
-					BeforeTokenProcessed(BeforeTokenProcessedArgs<T, U>(nullptr, otpNextToken, Base.CurrentTrivia, Base.CurrentTriviaLength));
+					BeforeTokenProcessed(BeforeTokenProcessedArgs<T, U>(nullptr, otpNextToken, trivia, triviaLength));
+					if (EmitTokensEarly) TriggerEarlyOnTokenProcessed(nullptr, otpNextToken, trivia, triviaLength);
 
 					break;
 				case ABParserResult::OnThenBeforeTokenProcessed:
 				{
 
-					OnTokenProcessed(OnTokenProcessedArgs<T, U>(firstOTP ? nullptr : otpPreviousToken, otpToken, otpNextToken, Leading, LeadingLength, Base.CurrentTrivia, Base.CurrentTriviaLength));
-					BeforeTokenProcessed(BeforeTokenProcessedArgs<T, U>(otpToken, otpNextToken, Base.CurrentTrivia, Base.CurrentTriviaLength));
+					OnTokenProcessedArgs<T, U> args(firstOTP ? nullptr : otpPreviousToken, otpToken, otpNextToken, leading, LeadingLength, trivia, triviaLength);
+
+					if (EmitTokensEarly) OnTrailingProcessed(args);
+					else OnTokenProcessed(args);
+
+					BeforeTokenProcessed(BeforeTokenProcessedArgs<T, U>(otpToken, otpNextToken, trivia, triviaLength));
+					if (EmitTokensEarly) TriggerEarlyOnTokenProcessed(otpToken, otpNextToken, trivia, triviaLength);
 
 					firstOTP = false;
 
@@ -144,33 +354,186 @@ namespace abparser {
 				}
 				case ABParserResult::StopAndFinalOnTokenProcessed:
 				{
-					if (!Base.CurrentEventToken)
-						continue;
+					OnTokenProcessedArgs<T, U> args(firstOTP ? nullptr : otpPreviousToken, otpToken, nullptr, leading, LeadingLength, trivia, triviaLength);
+
+					if (EmitTokensEarly) OnTrailingProcessed(args);
+					else OnTokenProcessed(args);
 
-					OnTokenProcessed(OnTokenProcessedArgs<T, U>(otpPreviousToken, otpToken, nullptr, Leading, LeadingLength, Base.CurrentTrivia, Base.CurrentTriviaLength));
 					break;
 				}
 				}
 			}
 
-			OnEnd(Base.CurrentEventToken ? Base.CurrentTrivia : Base.Text, Base.CurrentEventToken ? Base.CurrentTriviaLength : Base.TextLength);
+			endTrivia = hasToken ? trivia : Base.Text;
+			endTriviaLength = hasToken ? triviaLength : Base.TextLength;
+			return true;
 		}
 
-		void EnterTokenLimit(const T* limitName, uint8_t limitNameSize) { Base.EnterTokenLimit(limitName, limitNameSize); }
-		void EnterTokenLimit(std::basic_string<T>& limitName) { EnterTokenLimit(limitName.data(), limitName.size()); }
+		// The "Leading" gets swapped with the base's trivia, so it needs to be re-allocated whenever that is, to stay exactly as big.
+		void UpdateLeadingCapacity(uint32_t oldCapacity) {
+			if (Base.TriviaCapacity != oldCapacity || Leading == nullptr) {
+				if (Leading != nullptr)
+					delete[] Leading;
 
-		void ExitTokenLimit() { Base.ExitTokenLimit(); }
+				Leading = new T[(size_t)Base.TriviaCapacity + 1];
+			}
+		}
 
-		void EnterTriviaLimit(const T* limitName, uint8_t limitNameSize) { Base.EnterTriviaLimit(limitName, limitNameSize); }
-		void EnterTriviaLimit(std::basic_string<T>& limitName) { EnterTriviaLimit(limitName.data(), limitName.size()); }
+		// Carries on through any yields, unless the parse should be abandoned.
+		ABParserResult ContinueBase() {
+			ABParserResult result;
 
-		void ExitTriviaLimit() { Base.ExitTriviaLimit(); }
+			while ((result = Base.ContinueExecution()) == ABParserResult::Yielded)
+				if (Base.ShouldAbandonParse()) break;
 
-		virtual void OnStart() {}
-		virtual void OnEnd(T* leading, uint32_t leadingLength) {}
-		virtual void BeforeTokenProcessed(const BeforeTokenProcessedArgs<T, U>& args) {}
-		virtual void OnTokenProcessed(const OnTokenProcessedArgs<T, U>& args) {}
-		virtual void OnFirstUnlimitedCharacterProcessed(uint32_t pos) {}
+			return result;
+		}
+
+		void TriggerEarlyOnTokenProcessed(const TokenInformation<T, U>* previousToken, const TokenInformation<T, U>* token, T* leading, uint32_t leadingLength) {
+			OnTokenProcessedArgs<T, U> args(previousToken, token, nullptr, leading, leadingLength, nullptr, 0);
+			args.TrailingKnown = false;
+
+			OnTokenProcessed(args);
+		}
+
+		// If the last parse was only locating tokens, one of the two trivia buffers won't have been allocated.
+		void AllocateTriviaBuffers() {
+			if (Base.LocateOnly || !Base.TextCapacity) return;
+
+			if (!Leading) Leading = new T[(size_t)Base.TriviaCapacity + 1];
+			if (!Base.CurrentTrivia) Base.CurrentTrivia = new T[(size_t)Base.TriviaCapacity + 1];
+		}
+
+		// Works out what trivia the events should be given for the result that just came from the base.
+		void PrepareTrivia(ABParserTriviaChunkKind kind, T*& trivia, uint32_t& triviaLength) {
+			if (!Base.CurrentTriviaIsSpan) {
+				trivia = Base.CurrentTrivia;
+				triviaLength = Base.CurrentTriviaLength;
+				return;
+			}
+
+			PrepareTriviaFromText(Base.CurrentTriviaStart, Base.CurrentTriviaSpanLength, Base.CurrentTriviaSpanLimit, &Base.CurrentTriviaSkipped, kind, trivia, triviaLength);
+		}
+
+		// Gives trivia that's still in the text - straight from there if there's no limit to apply (or skipped tokens to leave out), otherwise filtered into the trivia buffer (which is free,
+		// as nothing was copied into it), or in pieces through "OnTriviaChunk" if it's too long for that.
+		void PrepareTriviaFromText(uint32_t start, uint32_t length, TriviaLimit<T>* limit, const std::vector<uint32_t>* skipped, ABParserTriviaChunkKind kind, T*& trivia, uint32_t& triviaLength) {
+			if (!limit && (!skipped || skipped->empty())) {
+				trivia = Base.Text + start;
+				triviaLength = length;
+				return;
+			}
+
+			trivia = Base.CurrentTrivia;
+			uint32_t offset = 0;
+
+			if (length <= Base.TriviaCapacity) {
+				triviaLength = Base.ReadTriviaChunk(start, length, limit, offset, trivia, Base.TriviaCapacity, skipped);
+				trivia[triviaLength] = 0;
+				return;
+			}
+
+			triviaLength = 0;
+			while (uint32_t chunkLength = Base.ReadTriviaChunk(start, length, limit, offset, trivia, Base.TriviaCapacity, skipped))
+				OnTriviaChunk(trivia, chunkLength, kind);
+		}
+
+		// Runs the whole parse on the pipeline's parsing thread, putting every result into the queue. If the events stop part-way through (e.g. from an exception), this abandons the parse.
+		void Produce(ABParserEventQueue<ABParserEventRecord<T>>& queue, std::atomic<bool>& cancelled, bool withTrivia) {
+			ABParserEventRecord<T> record;
+			ABParserResult result;
+
+			do {
+				result = Base.ContinueExecution();
+				if (result == ABParserResult::None) continue;
+
+				// If it's been cancelled or run out of time, the parse is abandoned here, and the events just get told to stop.
+				if (result == ABParserResult::Yielded) {
+					if (!Base.ShouldAbandonParse()) continue;
+					Base.ResetParseState();
+				}
+
+				record.Result = result;
+
+				if (result == ABParserResult::OnFirstUnlimitedCharacterProcessed || result == ABParserResult::Yielded)
+					record.TriviaStart = Base.InternalPosition;
+				else {
+					// Even when only locating tokens, the base still says where the trivia is, and what limit it was found under.
+					record.TriviaStart = Base.CurrentTriviaStart;
+					record.TriviaLength = withTrivia ? Base.CurrentTriviaSpanLength : 0;
+					record.ActiveTriviaLimit = withTrivia ? Base.CurrentTriviaSpanLimit : nullptr;
+
+					if (result != ABParserResult::StopAndFinalOnTokenProcessed) {
+						record.TokenIndex = Base.CurrentEventToken->MixedIdx;
+						record.TokenStart = Base.CurrentEventTokenStart;
+						record.TokenLength = Base.CurrentEventTokenLengthInText;
+					}
+				}
+
+				// This checks whether the events have stopped before every push, not just when the queue's full - otherwise a big enough queue would let the parse carry on through the rest of the text.
+				for (uint32_t attempts = 0; ; ABParserPipelineWait(attempts)) {
+					if (cancelled.load(std::memory_order_acquire)) {
+						Base.ResetParseState();
+						return;
+					}
+
+					if (queue.TryPush(record)) break;
+				}
+			} while (result != ABParserResult::StopAndFinalOnTokenProcessed && result != ABParserResult::Yielded);
+		}
+
+		ABParserResult PipelineNext(ABParserEventQueue<ABParserEventRecord<T>>* pipeline, ABParserEventRecord<T>& record, bool& hasToken) {
+			uint32_t attempts = 0;
+			while (!pipeline->TryPop(record))
+				ABParserPipelineWait(attempts);
+
+			if (record.Result == ABParserResult::FirstBeforeTokenProcessed || record.Result == ABParserResult::OnThenBeforeTokenProcessed)
+				hasToken = true;
+
+			return record.Result;
+		}
+
+		// Gives the next result from a recorded token stream, filling in the trivia like the base would have.
+		ABParserResult ReplayNext(ABParserTokenStreamReader* replay, bool& replayStarted, bool& hasToken) {
+
+			// Without any trivia limits, the first unlimited character is always straight away.
+			if (!replayStarted) {
+				replayStarted = true;
+				return ABParserResult::OnFirstUnlimitedCharacterProcessed;
+			}
+
+			if (replay->Next()) {
+				CopyTrivia(replay->TriviaStart, replay->TriviaLength);
+
+				ABParserResult result = hasToken ? ABParserResult::OnThenBeforeTokenProcessed : ABParserResult::FirstBeforeTokenProcessed;
+				hasToken = true;
+				return result;
+			}
+
+			CopyTrivia(replay->EndTriviaStart, replay->EndTriviaLength);
+			return ABParserResult::StopAndFinalOnTokenProcessed;
+		}
+
+		void CopyTrivia(uint32_t start, uint32_t length) {
+			if (Base.LocateOnly) length = 0;
+
+			Base.CurrentTriviaStart = start;
+			Base.CurrentTriviaSpanLength = length;
+			Base.CurrentTriviaSpanLimit = nullptr;
+
+			Base.CurrentTriviaIsSpan = length > Base.TriviaCapacity;
+			if (Base.CurrentTriviaIsSpan) length = 0;
+
+			Base.CurrentTriviaLength = length;
+
+			// An empty text never gets any trivia buffers.
+			if (!Base.CurrentTrivia) return;
+
+			for (uint32_t i = 0; i < length; i++)
+				Base.CurrentTrivia[i] = Base.Text[start + i];
+
+			Base.CurrentTrivia[length] = 0;
+		}
 	};
 }
 #endif
\ No newline at end of file
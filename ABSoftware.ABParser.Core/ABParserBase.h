@@ -3,9 +3,12 @@
 #include "ABParserHelpers.h"
 #include "ABParserConfig.h"
 #include "ABParserDebugging.h"
+#include "ABParserMemo.h"
 #include <string>
 #include <vector>
 #include <stack>
+#include <atomic>
+#include <chrono>
 #include <wchar.h>
 
 namespace abparser {
@@ -17,6 +20,10 @@ namespace abparser {
 
 		ABParserConfiguration<T, U>* Configuration;
 
+		// If this is set, the parser moves onto the latest version of the configuration from here whenever it's given new text (unless it's in the middle of a parse), so that it picks up
+		// any tokens that have been added or taken away since. This isn't owned by the parser.
+		ABParserConfigurationSource<T, U>* ConfigurationSource;
+
 		uint32_t CurrentEventTokenStart;
 		uint32_t CurrentEventTokenLengthInText;
 		ABParserInternalToken<T>* CurrentEventToken;
@@ -24,63 +31,132 @@ namespace abparser {
 		T* Text;
 		uint32_t TextLength;
 
+		// How long a text the buffers are currently big enough for - they're only re-allocated when a longer text comes along.
+		uint32_t TextCapacity;
+
 		T* CurrentTrivia;
 		uint32_t CurrentTriviaLength;
 
+		// Where the current trivia is in the text (before any trivia limit takes characters out of it).
+		uint32_t CurrentTriviaStart;
+		uint32_t CurrentTriviaSpanLength;
+
+		// When unsubscribed tokens are skipped (see "UnsubscribedTokens"), where any of them were within that span, as pairs of where they start and end - they aren't part of the trivia.
+		std::vector<uint32_t> CurrentTriviaSkipped;
+
+		// If this is set, then the "CurrentTrivia" buffer is only made big enough for this much trivia, rather than the whole text. Any trivia longer than that doesn't get copied at all,
+		// "CurrentTriviaIsSpan" gets set, and it's left in the text for "ReadTriviaChunk" to go through a piece at a time. Changing this takes effect from the next text given.
+		uint32_t MaxTriviaLength;
+
+		// How much trivia the "CurrentTrivia" buffer can actually hold.
+		uint32_t TriviaCapacity;
+
+		bool CurrentTriviaIsSpan;
+
+		// The trivia limit that was active when the current trivia was found (which is what still needs to be applied to it, if it's a span).
+		TriviaLimit<T>* CurrentTriviaSpanLimit;
+
+		// When this is set, only the tokens and where they are get given - the trivia is never copied out (so it's always empty), and its buffer isn't even allocated.
+		// This is for when all that's needed is to count or find the tokens.
+		bool LocateOnly;
+
 		std::stack<TokenLimit<T>*> CurrentEventTokenLimits;
 		std::stack<TriviaLimit<T>*> CurrentTriviaLimits;
 
-		ABParserResult ContinueExecution() {
+		// Only kept up-to-date when the core is compiled with "_ABP_COLLECT_STATS".
+		ABParserStatistics Statistics;
 
-			TriviaLimit<T>* currentTriviaLimit = nullptr;
+		// If set, pieces of text this parser goes through are remembered here so they don't need to be parsed again - see "ABParserMemo.h". This isn't owned by the parser.
+		ABParserMemo<T, U>* Memo;
 
-			if (isFinalizingVerifyTokens) {
-				ABParserResult result = FinalizeNextVerifyToken();
-				if (result != ABParserResult::None)
-					return result;
-			}
+		// What happens to the text of any tokens this parser isn't subscribed to - see "SetTokenSubscribed".
+		ABParserUnsubscribedTokens UnsubscribedTokens;
 
-			if (justStarted) PrepareForParse();
+		// "ContinueExecution" can be made to give back control part-way through a parse, by giving "Yielded" - calling it again carries on from exactly where it was. If none of these are set, it never does.
+		// This is how many characters each call can go through before it yields (0 for no limit).
+		uint32_t CharacterBudget;
 
-			if (notEncounteredFirstUnlimitedChar) {
-				if (CurrentTriviaLimits.empty()) return TriggerOnFirstUnlimitedCharacterProcessed();
-				else currentTriviaLimit = CurrentTriviaLimits.top();
-			}
+		// Once this has passed, or the flag has been set (from any thread), it yields at the next check. After that, "ShouldAbandonParse" says so, and the parse can be abandoned with "ResetParseState".
+		std::chrono::steady_clock::time_point Deadline;
+		const std::atomic<bool>* CancellationFlag;
 
-			_ABP_DEBUG_OUT("Continuing execution... Finished: %c ", (InternalPosition < TextLength) ? 'F' : 'T');
+		// How many characters apart those two get checked.
+		uint32_t YieldCheckInterval;
 
-			// The main loop - go through every character.
-			for (; InternalPosition < TextLength; InternalPosition++) {
-				_ABP_DEBUG_OUT("Current Position: %d", InternalPosition);
+		// Which record of the batch is being parsed (see "BeginBatch").
+		uint32_t CurrentRecord;
 
-				if (notEncounteredFirstUnlimitedChar)
-					if (ArrContainsChar(currentTriviaLimit->Data, currentTriviaLimit->DataLength, Text[InternalPosition])) {
-						if (currentTriviaLimit->IsWhitelist) return TriggerOnFirstUnlimitedCharacterProcessed();
-					} else if (!currentTriviaLimit->IsWhitelist) return TriggerOnFirstUnlimitedCharacterProcessed();
+		// If this is set, "ContinueExecution" also yields once it gets this far through the text, so something else can have a go at the same part of it first (see "ABParserMulti.h").
+		uint32_t PauseAt;
 
-				ABParserResult res = ProcessChar();
+		ABParserResult ContinueExecution() {
+			PrepareYieldChecks();
 
-				// Return any result we got.
-				if (res != ABParserResult::None) {
-					InternalPosition++;
-					return res;
-				}
+			// Tokens that aren't subscribed to stop at the same points any other token would, but there's nothing to give for them, so just carry on to the next one.
+			ABParserResult result;
+			do {
+				passedUnsubscribedToken = false;
+				result = ContinueToNextToken();
+			} while (passedUnsubscribedToken);
+
+			return result;
+		}
+
+		// Every token is subscribed to by default. A token that isn't still does everything a token does in the parse (like ending anything that overlaps it, and applying its limit rules),
+		// but doesn't stop "ContinueExecution", so no events are given for it. Its text is either left in the trivia around it, or taken out altogether, depending on "UnsubscribedTokens".
+		// "mixedIdx" is the index the token was given to the configuration in. These are kept until they're changed, across texts.
+		void SetTokenSubscribed(uint32_t mixedIdx, bool subscribed) {
+			if (!hasUnsubscribedTokens) {
+				if (subscribed) return;
+				subscribedTokens.assign(((size_t)Configuration->NumberOfTokens + 63) / 64, ~(uint64_t)0);
+				hasUnsubscribedTokens = true;
 			}
 
-			// If there's a token left, we'll prepare the leading and trailing for it so that when we trigger the "stop" result, it can be the final OnTokenProcessed.
-			if (CurrentEventToken)
-				PrepareLeadingAndTrailing((InternalPosition - 1) - CurrentEventTokenLengthInText, buildUp, buildUpLength, false, true);
+			if (subscribed) subscribedTokens[mixedIdx >> 6] |= (uint64_t)1 << (mixedIdx & 63);
+			else subscribedTokens[mixedIdx >> 6] &= ~((uint64_t)1 << (mixedIdx & 63));
+		}
+
+		// Sets all of them at once - bit "i" of "mask" is whether the token with the index "i" is subscribed to. Any tokens past the end of "mask" aren't.
+		void SetTokenSubscriptions(const uint64_t* mask, size_t maskLength) {
+			subscribedTokens.assign(((size_t)Configuration->NumberOfTokens + 63) / 64, 0);
+			for (size_t i = 0; i < maskLength && i < subscribedTokens.size(); i++)
+				subscribedTokens[i] = mask[i];
+
+			hasUnsubscribedTokens = true;
+		}
 
-			// Reset anything for next time.
+		void SubscribeToAllTokens() {
+			subscribedTokens.clear();
+			hasUnsubscribedTokens = false;
+		}
+
+		bool IsTokenSubscribed(uint32_t mixedIdx) {
+			return !hasUnsubscribedTokens || (subscribedTokens[mixedIdx >> 6] >> (mixedIdx & 63)) & 1;
+		}
+
+		bool HasUnsubscribedTokens() {
+			return hasUnsubscribedTokens;
+		}
+
+		bool ShouldAbandonParse() {
+			if (CancellationFlag && CancellationFlag->load(std::memory_order_relaxed)) return true;
+			return Deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= Deadline;
+		}
+
+		// Resets anything for next time. This happens automatically at the end of a parse, but can also be used to abandon a parse part-way through.
+		void ResetParseState() {
 			while (!CurrentEventTokenLimits.empty())
 				CurrentEventTokenLimits.pop();
 			while (!CurrentTriviaLimits.empty())
 				CurrentTriviaLimits.pop();
 			ResetCurrentEventTokens();
 
+			// Any tokens that were still being verified can't be carried over into the next parse.
+			StopAllVerify();
+
 			justStarted = true;
 			isFinalizingVerifyTokens = false;
-			return ABParserResult::StopAndFinalOnTokenProcessed;
+			finishingCharAfterVerifying = false;
 		}
 
 		ABParserBase() {
@@ -93,37 +169,117 @@ namespace abparser {
 		}
 
 		void InitParser() {
+			Configuration = nullptr;
+			ConfigurationSource = nullptr;
+			configurationVersion = UINT64_MAX;
+
 			Text = nullptr;
+			textBuffer = nullptr;
 			TextLength = 0;
+			TextCapacity = 0;
 			CurrentTrivia = nullptr;
 			CurrentTriviaLength = 0;
+			LocateOnly = false;
+
+			CurrentTriviaStart = 0;
+			CurrentTriviaSpanLength = 0;
+			MaxTriviaLength = 0;
+			TriviaCapacity = 0;
+			CurrentTriviaIsSpan = false;
+			CurrentTriviaSpanLimit = nullptr;
 
 			CurrentEventToken = nullptr;
 			CurrentEventTokenLengthInText = 0;
 			CurrentEventTokenStart = 0;
 
 			isFinalizingVerifyTokens = false;
-			buildUpStart = nullptr;
+			finishingCharAfterVerifying = false;
+			nextVerifyOrder = 0;
+
 			futureTokens = nullptr;
+			noFutureTokens.EndOfArray = true;
 			justStarted = true;
 
+			Memo = nullptr;
+
+			UnsubscribedTokens = ABParserUnsubscribedTokens::AsTrivia;
+
+			CharacterBudget = 0;
+			Deadline = std::chrono::steady_clock::time_point::max();
+			CancellationFlag = nullptr;
+			YieldCheckInterval = 4096;
+			yieldPosition = nextYieldCheck = UINT32_MAX;
+			PauseAt = UINT32_MAX;
+
+			batchBuffer = nullptr;
+			batchOffsets = nullptr;
+			batchLength = 0;
+			CurrentRecord = 0;
+			hasUnsubscribedTokens = false;
+			passedUnsubscribedToken = false;
+			triviaStart = 0;
+
+			codePointCachePosition = 0;
+			codePointCacheOffset = 0;
+
+			ResetStatistics();
+
 			// Estimated to have 2 verifyTokens at a given time.
 			verifyTokens.reserve(2);
 			verifyTokensToDelete.reserve(2);
 		}
 
+		// This only takes a reference to the configuration, so it's cheap enough to do for every parser.
 		void InitConfiguration(ABParserConfiguration<T, U>* configuration) {
+			configuration->AddReference();
+
+			// The subscriptions are sized for the configuration's tokens, so they can't be kept if it changes (and neither is anything left over from the text).
+			if (Configuration) {
+				if (Configuration != configuration) {
+					DisposeForTextChange();
+					SubscribeToAllTokens();
+				}
+				Configuration->Release();
+			}
+
 			Configuration = configuration;
+			ResetCurrentEventTokens();
+		}
+
+		// Moves onto the latest version from "ConfigurationSource", if there's a newer one than this parser has. Unlike "InitConfiguration", this keeps all of the buffers, as it only
+		// happens just before a new text. The subscriptions are reset though, since the tokens' indices can be different in the new version.
+		void RefreshConfiguration() {
+			if (!ConfigurationSource || !justStarted) return;
+
+			uint64_t version = ConfigurationSource->GetVersion();
+			if (version == configurationVersion && Configuration) return;
 
-			currentVerifyTriggers.reserve(Configuration->NumberOfMultiCharTokens);
-			currentVerifyTriggerStarts.reserve(Configuration->NumberOfMultiCharTokens);
+			ABParserConfiguration<T, U>* latest = ConfigurationSource->Acquire();
+			configurationVersion = version;
 
+			if (Configuration) {
+				if (Configuration != latest) {
+					DisposeDataForNextParse();
+					SubscribeToAllTokens();
+				}
+				Configuration->Release();
+			}
+
+			Configuration = latest;
 			ResetCurrentEventTokens();
 		}
 
+		void ResetStatistics() {
+			Statistics = ABParserStatistics();
+		}
+
 		~ABParserBase() {
 			_ABP_DEBUG_OUT("Disposing data for complete parser deletion.");
-			DisposeForTextChange(true);
+			DisposeForTextChange();
+			DisposeDataForNextParse();
+
+			if (Configuration)
+				Configuration->Release();
 		}
 
 		// Prepares for the next parse.
@@ -135,50 +291,165 @@ namespace abparser {
 			CurrentEventToken = nullptr;
 			CurrentEventTokenLengthInText = 0;
 			CurrentEventTokenStart = 0;
+			triviaStart = 0;
+			skippedSpans.clear();
+			CurrentTriviaSkipped.clear();
 
 			futureTokensHead = 0;
 			futureTokensTail = 0;
-			buildUpLength = 0;
-			buildUp = buildUpStart;
+			futureTokenRows.Rewind();
+			nextVerifyOrder = 0;
 			justStarted = false;
 
 			notEncounteredFirstUnlimitedChar = true;
+
+			// If the text was given while only locating tokens, there won't be a buffer for the trivia yet.
+			if (!LocateOnly && !CurrentTrivia && TextCapacity)
+				CurrentTrivia = new T[(size_t)TriviaCapacity + 1];
 		}
 
 		void InitString(T* text, uint32_t textLength) {
 			_ABP_DEBUG_OUT("Initializing String. Text Length: %d", textLength);
 
-			// Re-allocate anything that wouldn't work on the new text.
-			bool recreateTextSpecific = TextLength < textLength;
-			DisposeForTextChange(recreateTextSpecific);
+			RefreshConfiguration();
+			ReserveTextCapacity(textLength);
+			if (!textBuffer && TextCapacity) textBuffer = new T[TextCapacity];
 
-			Text = new T[textLength];
+			Text = textBuffer;
 			TextLength = textLength;
 
 			for (uint32_t i = 0; i < textLength; i++)
 				Text[i] = text[i];
 
-			if (recreateTextSpecific) {
-				buildUpStart = buildUp = new T[textLength];
-				CurrentTrivia = new T[(size_t)textLength + 1];
+			codePointCachePosition = 0;
+			codePointCacheOffset = 0;
+		}
+
+		// Parses "text" where it is, instead of copying it - so it has to stay there, unchanged, until the parse has finished. This way, any number of parsers can share one text.
+		void InitSharedString(const T* text, uint32_t textLength) {
+			RefreshConfiguration();
+			ReserveTextCapacity(textLength);
+
+			Text = (T*)text;
+			TextLength = textLength;
+
+			codePointCachePosition = 0;
+			codePointCacheOffset = 0;
+		}
 
-				futureTokens = new ABParserFutureToken<T>*[TextLength];
-				for (uint32_t i = 0; i < TextLength; i++)
-					futureTokens[i] = new ABParserFutureToken<T>[Configuration->NumberOfMultiCharTokens + 1];
+		// Re-allocates everything only if a text this long won't fit in what we've already got, so a parser that gets reused doesn't need to allocate anything.
+		void ReserveTextCapacity(uint32_t textLength) {
+			if (TextCapacity < textLength) {
+				DisposeForTextChange();
+
+				futureTokens = new ABParserFutureToken<T>*[textLength];
+				TextCapacity = textLength;
 			}
+
+			// The trivia buffer also has to follow "MaxTriviaLength", which could've changed since it was made.
+			uint32_t triviaCapacity = MaxTriviaLength && MaxTriviaLength < TextCapacity ? MaxTriviaLength : TextCapacity;
+			if (triviaCapacity == TriviaCapacity) return;
+
+			if (CurrentTrivia) delete[] CurrentTrivia;
+			CurrentTrivia = LocateOnly ? nullptr : new T[(size_t)triviaCapacity + 1];
+
+			TriviaCapacity = triviaCapacity;
+		}
+
+		// BATCHES:
+		// Lots of small records packed into one buffer can be parsed one after the other, as if each was given to "InitString" - record "i" is from "offsets[i]" up to "offsets[i + 1]",
+		// so there's one more offset than there are records. The buffers are made big enough for the longest record straight away, so moving between records never allocates anything.
+		// The records are parsed straight out of the buffer (like "InitSharedString"), so it needs to stay where it is until the batch is finished. Any parse that was still going is abandoned.
+		void BeginBatch(const T* buffer, uint32_t bufferLength, const uint32_t* offsets, uint32_t numberOfRecords) {
+			if (!IsValidBatch(bufferLength, offsets, numberOfRecords)) throw "The batch's offsets must not go backwards, or past the end of the buffer!";
+
+			if (!justStarted) ResetParseState();
+			DisposeDataForNextParse();
+
+			batchBuffer = buffer;
+			batchOffsets = offsets;
+			batchLength = numberOfRecords;
+			CurrentRecord = UINT32_MAX;
+
+			uint32_t longest = 0;
+			for (uint32_t i = 0; i < numberOfRecords; i++)
+				if (offsets[i + 1] - offsets[i] > longest) longest = offsets[i + 1] - offsets[i];
+
+			ReserveTextCapacity(longest);
+		}
+
+		// Whether "offsets" (with one more than "numberOfRecords" in it) only ever goes forwards, and stays inside a buffer "bufferLength" long.
+		static bool IsValidBatch(uint32_t bufferLength, const uint32_t* offsets, uint32_t numberOfRecords) {
+			for (uint32_t i = 0; i < numberOfRecords; i++)
+				if (offsets[i + 1] < offsets[i]) return false;
+
+			return offsets[numberOfRecords] <= bufferLength;
+		}
+
+		// Moves onto the next record, ready to be parsed (anything left over from the last one is reset first) - false once there aren't any more.
+		bool NextRecord() {
+			if (CurrentRecord + 1 >= batchLength) {
+				CurrentRecord = batchLength;
+				return false;
+			}
+
+			if (!justStarted) ResetParseState();
+			DisposeDataForNextParse();
+
+			CurrentRecord++;
+			InitSharedString(batchBuffer + batchOffsets[CurrentRecord], batchOffsets[CurrentRecord + 1] - batchOffsets[CurrentRecord]);
+			return true;
+		}
+
+		// Whether the last record has finished (or the batch has only just begun), so there needs to be a new one before "ContinueExecution".
+		bool IsBetweenRecords() {
+			return justStarted;
+		}
+
+		// How many characters come before "position" in the text. Positions are in code units, so in UTF-8 mode they're byte offsets, and this gives the code point offset instead.
+		// It's only worked out when it's asked for, carrying on from the last position that was asked for - so asking in increasing order (like the events come in) only goes over the text once.
+		uint32_t GetCodePointOffset(uint32_t position) {
+			if (!Configuration->IsUTF8) return position;
+			if (position > TextLength) position = TextLength;
+
+			if (position < codePointCachePosition) {
+				codePointCachePosition = 0;
+				codePointCacheOffset = 0;
+			}
+
+			for (; codePointCachePosition < position; codePointCachePosition++)
+				if (!IsUTF8Continuation((uint8_t)Text[codePointCachePosition]))
+					codePointCacheOffset++;
+
+			return codePointCacheOffset;
+		}
+
+		// Moves straight on to "position", as long as nothing's in progress - for when something else has already found that no token can start before there (see "ABParserMulti.h").
+		// This is only what the parse would have skipped over by itself anyway, so it doesn't change anything it gives.
+		void SkipTo(uint32_t position) {
+			if (justStarted || notEncounteredFirstUnlimitedChar || position <= InternalPosition || !IsIdle()) return;
+			if (position > TextLength) position = TextLength;
+
+			InternalPosition = futureTokensHead = futureTokensTail = position;
 		}
 
 		bool EnterTokenLimit(const std::basic_string<U>& limitName) {
 			auto item = Configuration->TokenLimits.find(limitName);
 			if (item == Configuration->TokenLimits.end()) return false;
 
-			_ABP_DEBUG_OUT("Entered into token limit");
-			CurrentEventTokenLimits.push(item->second);
-			SetCurrentEventTokens(item->second);
+			EnterTokenLimit(item->second);
 			return true;
 		}
 
+		void EnterTokenLimit(TokenLimit<T>* limit) {
+			_ABP_DEBUG_OUT("Entered into token limit");
+			_ABP_STAT_INC(TokenLimitsEntered);
+			CurrentEventTokenLimits.push(limit);
+			SetCurrentEventTokens(limit);
+		}
+
 		void ExitTokenLimit() {
+			_ABP_STAT_INC(TokenLimitsExited);
 			CurrentEventTokenLimits.pop();
 
 			if (CurrentEventTokenLimits.empty())
@@ -191,12 +462,18 @@ namespace abparser {
 			auto item = Configuration->TriviaLimits.find(limitName);
 			if (item == Configuration->TriviaLimits.end()) return false;
 
-			_ABP_DEBUG_OUT("Entered into trivia limit");
-			CurrentTriviaLimits.push(item->second);
+			EnterTriviaLimit(item->second);
 			return true;
 		}
 
+		void EnterTriviaLimit(TriviaLimit<T>* limit) {
+			_ABP_DEBUG_OUT("Entered into trivia limit");
+			_ABP_STAT_INC(TriviaLimitsEntered);
+			CurrentTriviaLimits.push(limit);
+		}
+
 		void ExitTriviaLimit() {
+			_ABP_STAT_INC(TriviaLimitsExited);
 			CurrentTriviaLimits.pop();
 		}
 
@@ -210,104 +487,320 @@ namespace abparser {
 			verifyTokensToDelete.clear();
 		}
 
-		void DisposeForTextChange(bool disposeBuildUpAndFutureTokens) {
-			if (disposeBuildUpAndFutureTokens) {
+		// Frees all of the buffers that were made for the text. The next "InitString" will make them again.
+		void DisposeForTextChange() {
+			if (futureTokens) {
+				delete[] futureTokens;
+				futureTokens = nullptr;
+			}
 
-				if (futureTokens) {
-					for (uint32_t i = 0; i < TextLength; i++)
-						delete[] futureTokens[i];
-					delete[] futureTokens;
-					futureTokens = nullptr;
-				}
+			futureTokenRows.Clear();
 
-				if (buildUpStart) {
-					delete[] buildUpStart;
-					buildUpStart = nullptr;
-				}
+			if (CurrentTrivia) {
+				delete[] CurrentTrivia;
+				CurrentTrivia = nullptr;
+			}
 
-				if (CurrentTrivia) {
-					delete[] CurrentTrivia;
-					CurrentTrivia = nullptr;
-				}
+			if (textBuffer) {
+				delete[] textBuffer;
+				textBuffer = nullptr;
 			}
 
-			if (Text) {
-				delete[] Text;
-				Text = nullptr;
+			Text = nullptr;
+
+			TextLength = 0;
+			TextCapacity = 0;
+			TriviaCapacity = 0;
+		}
+
+		// Copies the next piece of the current trivia (if it's a span) into "buffer", with any trivia limit that was active applied to it. "offset" is how far through the span we are,
+		// and gets moved on past what was read - this gives how much was put into the buffer, which is 0 once the whole span has been gone through. Characters are never split between pieces.
+		uint32_t ReadTriviaChunk(uint32_t& offset, T* buffer, uint32_t bufferSize) {
+			return ReadTriviaChunk(CurrentTriviaStart, CurrentTriviaSpanLength, CurrentTriviaSpanLimit, offset, buffer, bufferSize, &CurrentTriviaSkipped);
+		}
+
+		// The same, but for any span of the text, leaving out any "skipped" spans (see "CurrentTriviaSkipped"). This only reads the text, so it's fine to use while another thread is running the parse.
+		uint32_t ReadTriviaChunk(uint32_t start, uint32_t length, TriviaLimit<T>* limit, uint32_t& offset, T* buffer, uint32_t bufferSize, const std::vector<uint32_t>* skipped = nullptr) {
+			T* trivia = Text + start;
+			uint32_t written = 0;
+			size_t skip = 0;
+
+			while (offset < length) {
+				if (skipped) {
+					while (skip < skipped->size() && (*skipped)[skip + 1] <= start + offset) skip += 2;
+
+					if (skip < skipped->size() && (*skipped)[skip] <= start + offset) {
+						offset = (*skipped)[skip + 1] - start;
+						continue;
+					}
+				}
+
+				uint8_t characterLength = CharacterLengthAt(trivia, offset, length);
+				if (characterLength > bufferSize - written) break;
+
+				if (!limit || SetContainsCharacter(limit->Data, limit->DataLength, trivia + offset, characterLength) == limit->IsWhitelist)
+					for (uint8_t k = 0; k < characterLength; k++)
+						buffer[written++] = trivia[offset + k];
+
+				offset += characterLength;
 			}
+
+			return written;
 		}
 
 	private:
 		bool notEncounteredFirstUnlimitedChar;
 		bool justStarted;
 
+		// The text's own buffer, for when it's been copied - "Text" points somewhere else if it's shared.
+		T* textBuffer;
+
+		// The row of future tokens that started at each position - the rows come from "futureTokenRows", and any position where nothing started just points at "noFutureTokens".
 		ABParserFutureToken<T>** futureTokens;
 		uint32_t futureTokensHead;
 		uint32_t futureTokensTail;
+		ABParserFutureTokenArena<T> futureTokenRows;
+		ABParserFutureToken<T> noFutureTokens;
+
+		// The multi-char tokens that start at the current position, collected up before they get a row.
+		std::vector<MultiCharToken<T>*> newFutureTokens;
+
+		// Where "GetCodePointOffset" got up to last time.
+		uint32_t codePointCachePosition;
+		uint32_t codePointCacheOffset;
 
 		// When all of the triggers in a verify token gets removed, then we finalize that token! However, sometimes there may be lots of verify tokens that all had the same triggers, so, we'll finalize them all in one go with this!
 		bool isFinalizingVerifyTokens;
-		ABParserVerifyToken<T>* lastVerifyToken;
-		uint32_t finalizingVerifyTokensCurrentEventToken;
 
-		std::vector<ABParserVerifyToken<T>*> verifyTokens;
+		// When verify tokens get confirmed part-way through a character, we stop to finalize them, and then need to pick up that character from where we left off.
+		bool finishingCharAfterVerifying;
+
+		// Which tokens are subscribed to, one bit for each - this is only used when "hasUnsubscribedTokens" is set.
+		std::vector<uint64_t> subscribedTokens;
+		bool hasUnsubscribedTokens;
+
+		// Which version from "ConfigurationSource" the configuration is.
+		uint64_t configurationVersion;
 
-		// The verify token right at the end of the verifyTokens.
-		ABParserVerifyToken<T>* currentVerifyToken;
+		// Set when the step that just happened stopped on a token that isn't subscribed to, so "ContinueExecution" needs to keep going.
+		bool passedUnsubscribedToken;
+
+		// Where the trivia for the next token starts - just after the last token.
+		uint32_t triviaStart;
+
+		// Unsubscribed tokens that have been skipped since "triviaStart", which need leaving out of the trivia (see "CurrentTriviaSkipped").
+		std::vector<uint32_t> skippedSpans;
+
+		const T* batchBuffer;
+		const uint32_t* batchOffsets;
+		uint32_t batchLength;
+
+		// Where the current call to "ContinueExecution" runs out of characters, and where it next needs to check whether to yield (which is never past that).
+		uint32_t yieldPosition;
+		uint32_t nextYieldCheck;
+
+		void PrepareYieldChecks() {
+			uint64_t start = justStarted ? 0 : InternalPosition;
+
+			yieldPosition = CharacterBudget && start + CharacterBudget < TextLength ? (uint32_t)(start + CharacterBudget) : UINT32_MAX;
+			if (PauseAt < yieldPosition && PauseAt < TextLength) yieldPosition = PauseAt;
+			nextYieldCheck = yieldPosition;
+
+			if (CancellationFlag || Deadline != std::chrono::steady_clock::time_point::max())
+				if (start + YieldCheckInterval < nextYieldCheck) nextYieldCheck = (uint32_t)(start + YieldCheckInterval);
+		}
+
+		bool ShouldYield() {
+			if (InternalPosition >= yieldPosition || ShouldAbandonParse()) return true;
+
+			uint64_t next = (uint64_t)InternalPosition + YieldCheckInterval;
+			nextYieldCheck = next < yieldPosition ? (uint32_t)next : yieldPosition;
+			return false;
+		}
+
+		std::vector<ABParserVerifyToken<T>*> verifyTokens;
+		uint32_t nextVerifyOrder;
 
 		// As we're preparing a token for verification, we'll use this temporaily.
 		std::vector<ABParserFutureToken<T>*> currentVerifyTriggers;
 		std::vector<uint32_t> currentVerifyTriggerStarts;
 
-		// When verify tokens are finalized, the buildUp is pushed forwards to make it point towards the last verify tokens' trailing, since that is the correct leading for the next token. This is the buildUp without any of that "movement".
-		T* buildUpStart;
-		T* buildUp;
-		uint32_t buildUpLength;
-
-		uint32_t buildUpOffset;
-
 		SingleCharToken<T>** singleCharCurrentTokens;
-		uint16_t singleCharCurrentTokensLength;
+		uint32_t singleCharCurrentTokensLength;
+		const FirstCharacterTable<T>* singleCharCurrentStarts;
 
+		// With a trie, these are only the tokens that can't be looked up in it.
 		MultiCharToken<T>** multiCharCurrentTokens;
-		uint16_t multiCharCurrentTokensLength;
+		uint32_t multiCharCurrentTokensLength;
+		const FirstCharacterTable<T>* multiCharCurrentStarts;
+		const ABParserTokenTrie<T>* multiCharCurrentTrie;
+
+		RunToken<T>** runCurrentTokens;
+		uint32_t runCurrentTokensLength;
+		const FirstCharacterTable<T>* runCurrentStarts;
+
+		const FirstCharacterScanner<T>* currentTokenStarts;
 
 		std::vector<ABParserVerifyToken<T>*> verifyTokensToDelete;
+		static const size_t MaxStoppedVerifyTokens = 4096;
+
+		ABParserResult ContinueToNextToken() {
+
+			TriviaLimit<T>* currentTriviaLimit = nullptr;
+
+			if (isFinalizingVerifyTokens) {
+				ABParserResult result = FinalizeNextVerifyToken();
+				if (result != ABParserResult::None || passedUnsubscribedToken)
+					return result;
+			}
+
+			if (justStarted) PrepareForParse();
+
+			if (notEncounteredFirstUnlimitedChar) {
+				if (CurrentTriviaLimits.empty()) return TriggerOnFirstUnlimitedCharacterProcessed();
+				else currentTriviaLimit = CurrentTriviaLimits.top();
+			}
+
+			_ABP_DEBUG_OUT("Continuing execution... Finished: %c ", (InternalPosition < TextLength) ? 'F' : 'T');
+
+			// If nothing's in progress, what comes next only depends on the token limit and the text from here, so we might have already seen it.
+			// (Not with run tokens though - whether there's a run, and how long it is, can depend on text past the end of what would be remembered)
+			bool canMemo = Memo && Memo->Configuration == Configuration && !Configuration->NumberOfRunTokens && !notEncounteredFirstUnlimitedChar && IsIdle();
+			uint32_t memoStart = InternalPosition;
+			uint64_t memoKey = 0;
+			TokenLimit<T>* memoLimit = nullptr;
+
+			if (canMemo) {
+				memoLimit = CurrentEventTokenLimits.empty() ? nullptr : CurrentEventTokenLimits.top();
+				memoKey = Memo->GetKey(memoLimit, Text + memoStart, GetMemoLength(memoStart));
+
+				ABParserInternalToken<T>* token;
+				uint32_t tokenOffset, tokenLength, spanLength;
+				if (Memo->TryGet(memoLimit, Text + memoStart, GetMemoLength(memoStart), memoKey, token, tokenOffset, tokenLength, spanLength)) {
+					InternalPosition = futureTokensHead = futureTokensTail = memoStart + spanLength;
+
+					if (!IsTokenSubscribed(token->MixedIdx))
+						return PassUnsubscribedToken(token, memoStart + tokenOffset, tokenLength);
+
+					PrepareLeadingAndTrailing(memoStart + tokenOffset, false);
+					return QueueTokenAndReturnFinalizeResult(token, memoStart + tokenOffset, tokenLength);
+				}
+			}
+
+			// The main loop - go through every character.
+			for (; InternalPosition < TextLength; InternalPosition++) {
+
+				// With nothing in progress, any characters that can't start a token wouldn't do anything, so skip straight to the next one that can.
+				// (This only looks as far as the next time it needs to check whether to yield, so a long stretch without any tokens can't hold that up)
+				if (!notEncounteredFirstUnlimitedChar && IsIdle()) {
+
+					// Nothing can be referring to any of the future tokens or stopped verify tokens from before here anymore. The verify tokens are normally just left until the
+					// parse has finished, but a text with lots of tokens in it could stop a lot of them, so they don't all get kept until then.
+					futureTokenRows.Rewind();
+					if (verifyTokensToDelete.size() >= MaxStoppedVerifyTokens) DisposeDataForNextParse();
+
+					InternalPosition = futureTokensHead = futureTokensTail = currentTokenStarts->FindNext(Text, InternalPosition, nextYieldCheck < TextLength ? nextYieldCheck : TextLength);
+					if (InternalPosition == TextLength) break;
+				}
+
+				if (InternalPosition >= nextYieldCheck && ShouldYield()) return ABParserResult::Yielded;
+
+				_ABP_DEBUG_OUT("Current Position: %d", InternalPosition);
+
+				// (The rest of a multi-byte character was already decided on by its first byte)
+				if (notEncounteredFirstUnlimitedChar && !(Configuration->IsUTF8 && IsUTF8Continuation((uint8_t)Text[InternalPosition])))
+					if (SetContainsCharacter(currentTriviaLimit->Data, currentTriviaLimit->DataLength, Text + InternalPosition, CharacterLengthAt(Text, InternalPosition, TextLength))) {
+						if (currentTriviaLimit->IsWhitelist) return TriggerOnFirstUnlimitedCharacterProcessed();
+					} else if (!currentTriviaLimit->IsWhitelist) return TriggerOnFirstUnlimitedCharacterProcessed();
+
+				ABParserResult res = ProcessChar();
+
+				// Return any result we got.
+				if (res != ABParserResult::None || passedUnsubscribedToken) {
+					InternalPosition++;
+
+					// Only remember it if it finished with nothing in progress too, so that it can be picked up again from just the token.
+					if (canMemo && !passedUnsubscribedToken && IsIdle() && InternalPosition <= memoStart + GetMemoLength(memoStart))
+						Memo->Add(memoLimit, Text + memoStart, InternalPosition - memoStart, memoKey, CurrentEventToken, CurrentEventTokenStart - memoStart, CurrentEventTokenLengthInText);
+
+					return res;
+				}
+			}
+
+			// Nothing that's still being collected can finish now, so any tokens still waiting to be verified against them really were in the text.
+			if (verifyTokens.size()) {
+				for (uint32_t i = futureTokensHead; i < futureTokensTail; i++)
+					for (uint32_t j = 0; !futureTokens[i][j].EndOfArray; j++)
+						if (!futureTokens[i][j].CollectionComplete) DisableFutureToken(&futureTokens[i][j]);
+
+				if (isFinalizingVerifyTokens) return FinalizeNextVerifyToken();
+			}
+
+			// If there's a token left, we'll prepare the leading and trailing for it so that when we trigger the "stop" result, it can be the final OnTokenProcessed.
+			if (CurrentEventToken)
+				PrepareLeadingAndTrailing(TextLength, true);
+
+			ResetParseState();
+			return ABParserResult::StopAndFinalOnTokenProcessed;
+		}
 
 		// COLLECT
 		ABParserResult ProcessChar() {
 
 			_ABP_DEBUG_OUT("Processing character: %c", Text[InternalPosition]);
 
-			UpdateCurrentFutureTokens();
-			AddNewFutureTokens();
-			ABParserResult result = ProcessFinishedTokens();
+			if (finishingCharAfterVerifying)
+				finishingCharAfterVerifying = false;
+			else {
+				_ABP_STAT_INC(CharactersProcessed);
+				UpdateCurrentFutureTokens();
+
+				// If that confirmed any verify tokens, they all came before anything that could finish on this character, so we'll finalize those first, and then come back to finish this character.
+				if (isFinalizingVerifyTokens) {
+					finishingCharAfterVerifying = true;
+					return FinalizeNextVerifyToken();
+				}
+			}
 
-			if (result != ABParserResult::None) return result;
-			if (isFinalizingVerifyTokens) return FinalizeNextVerifyToken();
+			// Runs are decided on as soon as they start, so they can only start where nothing else is being collected.
+			if (runCurrentTokensLength && runCurrentStarts->MayContain(Text[InternalPosition]) && IsIdle()) {
+				ABParserResult result = ProcessRunTokens();
+				if (result != ABParserResult::None || passedUnsubscribedToken) return result;
+			}
 
-			AddCharToBuildUp(Text[InternalPosition]);
-			return ABParserResult::None;
+			AddNewFutureTokens();
+			return ProcessFinishedTokens();
 		}
 
-		void AddCharToBuildUp(T ch) {
-			if (verifyTokens.empty())
-				buildUp[buildUpLength++] = ch;
-			else
-				currentVerifyToken->TrailingBuildUp[currentVerifyToken->TrailingBuildUpLength++] = ch;
+		// The first run token (in the order the configuration has them) that has a long enough run starting here is the token - everything in the run is skipped straight over.
+		ABParserResult ProcessRunTokens() {
+			for (uint32_t i = 0; i < runCurrentTokensLength; i++) {
+				uint32_t length = runCurrentTokens[i]->LengthAt(Text, InternalPosition, TextLength);
+				if (length < runCurrentTokens[i]->MinLength) continue;
+
+				_ABP_DEBUG_OUT("Finished run token!");
+
+				uint32_t start = InternalPosition;
+				futureTokensHead = futureTokensTail = start + length;
+				InternalPosition = start + length - 1;
+
+				return FinalizeToken(runCurrentTokens[i], start, length);
+			}
+
+			return ABParserResult::None;
 		}
 
 		void UpdateCurrentFutureTokens() {
 
 			_ABP_DEBUG_OUT("Updating future tokens.");
+			_ABP_STAT_TIME(UpdateFutureTokensTime);
 
 			for (uint32_t i = futureTokensHead; i < futureTokensTail; i++)
 			{
 				bool hasUnfinalizedFutureToken = false;
 
-				for (uint16_t j = 0; j < Configuration->NumberOfMultiCharTokens; j++)
+				for (uint32_t j = 0; !futureTokens[i][j].EndOfArray; j++)
 				{
-					if (futureTokens[i][j].EndOfArray) break;
 					if (futureTokens[i][j].CollectionComplete) continue;
 
 					hasUnfinalizedFutureToken = true;
@@ -315,12 +808,21 @@ namespace abparser {
 					futureTokens[i][j].LengthInText++;
 
 					// If this future tokens' detection limit tells us to ignore this character, then do so.
-					if (futureTokens[i][j].Token->DetectionLimitSize > 0)
-						if (ArrContainsChar(futureTokens[i][j].Token->DetectionLimit, futureTokens[i][j].Token->DetectionLimitSize, Text[InternalPosition]))
+					if (futureTokens[i][j].Token->DetectionLimitSize > 0) {
+						if (futureTokens[i][j].CodeUnitsToIgnore) {
+							futureTokens[i][j].CodeUnitsToIgnore--;
 							continue;
+						}
+
+						uint8_t characterLength = CharacterLengthAt(Text, InternalPosition, TextLength);
+						if (SetContainsCharacter(futureTokens[i][j].Token->DetectionLimit, futureTokens[i][j].Token->DetectionLimitSize, Text + InternalPosition, characterLength)) {
+							futureTokens[i][j].CodeUnitsToIgnore = characterLength - 1;
+							continue;
+						}
+					}
 
 					// Check if this character matches the next character in this token.
-					if (futureTokens[i][j].Token->TokenContents[futureTokens[i][j].NoOfCharactersMatched] == Text[InternalPosition]) {
+					if (CharactersMatch(futureTokens[i][j].Token->TokenContents[futureTokens[i][j].NoOfCharactersMatched], Text[InternalPosition], futureTokens[i][j].Token->IgnoreCase)) {
 						futureTokens[i][j].NoOfCharactersMatched++;
 
 						// If all the characters have matched, then mark this token as complete.
@@ -341,27 +843,47 @@ namespace abparser {
 		void AddNewFutureTokens() {
 
 			_ABP_DEBUG_OUT("Adding future tokens.");
+			_ABP_STAT_TIME(AddFutureTokensTime);
 			futureTokensTail++;
 
-			uint16_t currentLength = 0;
-			for (uint16_t i = 0; i < multiCharCurrentTokensLength; i++)
-				if (multiCharCurrentTokens[i]->TokenContents[0] == Text[InternalPosition])
-					AddFutureToken(multiCharCurrentTokens[i], currentLength++);
+			newFutureTokens.clear();
+			if (multiCharCurrentStarts->MayContain(Text[InternalPosition])) {
+				if (multiCharCurrentTrie) multiCharCurrentTrie->FindMatches(Text, InternalPosition, TextLength, newFutureTokens);
+
+				for (uint32_t i = 0; i < multiCharCurrentTokensLength; i++)
+					if (CharactersMatch(multiCharCurrentTokens[i]->TokenContents[0], Text[InternalPosition], multiCharCurrentTokens[i]->IgnoreCase))
+						newFutureTokens.push_back(multiCharCurrentTokens[i]);
+
+				// They're kept in the same order as the configuration has them, just like they would be without the trie.
+				if (multiCharCurrentTrie && newFutureTokens.size() > 1)
+					std::sort(newFutureTokens.begin(), newFutureTokens.end(), [](MultiCharToken<T>* first, MultiCharToken<T>* second) { return first->Index < second->Index; });
+			}
+
+			if (newFutureTokens.empty()) {
+				futureTokens[InternalPosition] = &noFutureTokens;
+				return;
+			}
+
+			uint32_t numberOfNewTokens = (uint32_t)newFutureTokens.size();
+			ABParserFutureToken<T>* row = futureTokens[InternalPosition] = futureTokenRows.Allocate(numberOfNewTokens + 1);
+
+			for (uint32_t i = 0; i < numberOfNewTokens; i++)
+				AddFutureToken(&row[i], newFutureTokens[i]);
 
-			futureTokens[InternalPosition][currentLength].EndOfArray = true;
+			row[numberOfNewTokens].EndOfArray = true;
 		}
 
 		ABParserResult ProcessFinishedTokens() {
 			_ABP_DEBUG_OUT("Processing finished future tokens.");
+			_ABP_STAT_TIME(ProcessFinishedTokensTime);
 
 			// We deal with the multiple character long tokens first because they might contain single character tokens, so, if we process them first,
 			// then the "PrepareSingleCharForVerification" can look at these futureTokens. Also, longer futureTokens are more important than shorter ones.
 			for (uint32_t i = futureTokensHead; i < futureTokensTail; i++) {
 
 				// We'll ignore if there are two tokens both finished, as the only way that can occur is if two tokens are identical.
-				for (uint16_t j = 0; j < Configuration->NumberOfMultiCharTokens; j++) {
+				for (uint32_t j = 0; !futureTokens[i][j].EndOfArray; j++) {
 
-					if (futureTokens[i][j].EndOfArray) break;
 					if (futureTokens[i][j].CollectionComplete) continue;
 
 					if (futureTokens[i][j].Finished) {
@@ -371,34 +893,38 @@ namespace abparser {
 						futureTokens[i][j].CollectionComplete = true;
 
 						// If we are currently verifying, then we need to do some extra checks on it.
-						if (verifyTokens.size())
-							if (int result = CheckFinishedFutureToken(&futureTokens[i][j], i))
-								if (result == -1) return ABParserResult::None;
-								else return static_cast<ABParserResult>(result);
+						if (verifyTokens.size()) {
+							int result = CheckFinishedFutureToken(&futureTokens[i][j], i);
+							if (result == -1) continue;
+							else if (result || passedUnsubscribedToken) return static_cast<ABParserResult>(result);
+						}
 
 						// Finalize it or verify it.
 						if (PrepareMultiCharForVerification(&futureTokens[i][j], i))
-							StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(&futureTokens[i][j], false, i, GenerateVerifyTrailing())));
+							StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(&futureTokens[i][j], false, i)));
 						else {
 							StopAllVerify();
-							return FinalizeToken(&futureTokens[i][j], i, buildUp, buildUpLength, true);
+							return FinalizeToken(&futureTokens[i][j], i);
 						}
 							
 					}
 				};
 			}
 
-			for (uint16_t i = 0; i < singleCharCurrentTokensLength; i++) {
-				if (singleCharCurrentTokens[i]->TokenChar == Text[InternalPosition]) {
+			if (!singleCharCurrentStarts->MayContain(Text[InternalPosition]))
+				return ABParserResult::None;
+
+			for (uint32_t i = 0; i < singleCharCurrentTokensLength; i++) {
+				if (CharactersMatch(singleCharCurrentTokens[i]->TokenChar, Text[InternalPosition], singleCharCurrentTokens[i]->IgnoreCase)) {
 
 					_ABP_DEBUG_OUT("Finished single-char token!");
 
 					// Finalize it or verify it.
 					if (PrepareSingleCharForVerification(Text[InternalPosition], singleCharCurrentTokens[i]))
-						StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(singleCharCurrentTokens[i], true, InternalPosition, GenerateVerifyTrailing())));
+						StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(singleCharCurrentTokens[i], true, InternalPosition)));
 					else {
 						StopAllVerify();
-						return FinalizeToken(singleCharCurrentTokens[i], InternalPosition, buildUp, buildUpLength, true);
+						return FinalizeToken(singleCharCurrentTokens[i], InternalPosition);
 					}
 				}
 			}
@@ -409,6 +935,7 @@ namespace abparser {
 		// VERIFY
 		void StartVerify(ABParserVerifyToken<T>* token) {
 			_ABP_DEBUG_OUT("Starting verify.");
+			_ABP_STAT_INC(VerifyTokensStarted);
 
 			AddVerifyToken(token);
 			currentVerifyTriggers.clear();
@@ -417,14 +944,19 @@ namespace abparser {
 
 		void StopAllVerify() {
 			if (verifyTokens.size()) {
-				for (size_t i = 0; i < verifyTokens.size(); i++)
+				_ABP_STAT_ADD(VerifyTokensStopped, verifyTokens.size());
+				for (size_t i = 0; i < verifyTokens.size(); i++) {
+					verifyTokens[i]->IsStopped = true;
 					verifyTokensToDelete.push_back(verifyTokens[i]);
+				}
 				verifyTokens.clear();
 			}
 		}
 
 		void StopVerify(uint32_t tokenIndex) {
+			_ABP_STAT_INC(VerifyTokensStopped);
 			auto tokenToRemoveIterator = verifyTokens.begin() + tokenIndex;
+			verifyTokens[tokenIndex]->IsStopped = true;
 			verifyTokensToDelete.push_back(verifyTokens[tokenIndex]);
 			verifyTokens.erase(tokenToRemoveIterator);
 		}
@@ -435,12 +967,11 @@ namespace abparser {
 			bool needsToBeVerified = false;
 
 			for (uint32_t i = futureTokensHead; i < futureTokensTail; i++)
-				for (uint16_t j = 0; j < Configuration->NumberOfMultiCharTokens; j++) {
-					if (futureTokens[i][j].EndOfArray) break;
+				for (uint32_t j = 0; !futureTokens[i][j].EndOfArray; j++) {
 					if (futureTokens[i][j].CollectionComplete) continue;
 
 					ABParserFutureToken<T>* multiCharToken = &futureTokens[i][j];
-					if (multiCharToken->Token->TokenContents[InternalPosition - i] == ch) {
+					if (CharactersMatch(multiCharToken->Token->TokenContents[InternalPosition - i], ch, multiCharToken->Token->IgnoreCase)) {
 
 						needsToBeVerified = true;
 
@@ -465,8 +996,7 @@ namespace abparser {
 
 			for (uint32_t i = futureTokensHead; i <= index; i++) {
 
-				for (uint16_t j = 0; j < Configuration->NumberOfMultiCharTokens; j++) {
-					if (futureTokens[i][j].EndOfArray) break;
+				for (uint32_t j = 0; !futureTokens[i][j].EndOfArray; j++) {
 					if (futureTokens[i][j].CollectionComplete) continue;
 
 					ABParserFutureToken<T>* futureToken = &futureTokens[i][j];
@@ -474,16 +1004,7 @@ namespace abparser {
 
 					uint32_t distanceAway = index - i;
 
-					// If the token isn't even long enough to contain our token, then we can ignore it.
-					if (token->Token->TokenLength > multiCharToken->TokenLength)
-						continue;
-
-					bool contains = true;
-					for (uint32_t k = 0; k < token->Token->TokenLength; k++)
-						if (token->Token->TokenContents[k] != multiCharToken->TokenContents[k + distanceAway])
-							contains = false;
-
-					if (contains) {
+					if (Configuration->MultiCharTokenContains(multiCharToken, token->Token, distanceAway)) {
 						currentVerifyTriggers.push_back(futureToken);
 						currentVerifyTriggerStarts.push_back(i);
 						needsToBeVerified = true;
@@ -504,165 +1025,191 @@ namespace abparser {
 		void CheckDisabledFutureToken(ABParserFutureToken<T>* token) {
 			_ABP_DEBUG_OUT("Checking disabled future token...");
 
-			for (uint32_t i = 0; i < verifyTokens.size(); i++) {
-				bool hasRemainingTriggers = false;
+			// Only the verify tokens that have this as a trigger are affected, and the token keeps a chain of exactly those.
+			ABParserTriggerReference<T> reference = token->FirstReference;
+			while (reference.Token) {
+				ABParserVerifyToken<T>* verifyToken = reference.Token;
+				uint32_t slot = reference.Slot;
+				reference = verifyToken->NextReferences[slot];
 
-				for (uint16_t j = 0; j < verifyTokens[i]->TriggersLength; j++) {
+				if (verifyToken->IsStopped || verifyToken->TriggersLength == 0 || verifyToken->Triggers[slot] != token)
+					continue;
 
-					ABParserFutureToken<T>** trigger = &verifyTokens[i]->Triggers[j];
-
-					if (*trigger == nullptr)
-						continue;
-
-					// Since this trigger has just ended, we can now remove it.
-					if (*trigger == token) *trigger = nullptr;
-					else hasRemainingTriggers = true;
-				}
+				// Since this trigger has just ended, we can now remove it.
+				verifyToken->Triggers[slot] = nullptr;
 
 				// If there are no more triggers left in this token, then it WAS actually the token in the text - not the triggers! So, we'll go ahead and get ready to start finalizing this token.
-				if (!hasRemainingTriggers) {
+				if (--verifyToken->RemainingTriggers == 0) {
 					// We'll reset the trigger length down to 0, to specifically tell us that this is one of the verify tokens that got completed.
-					verifyTokens[i]->TriggersLength = 0;
+					verifyToken->TriggersLength = 0;
 					isFinalizingVerifyTokens = true;
 				}
 			}
-
 		}
 
 		int CheckFinishedFutureToken(ABParserFutureToken<T>* token, uint32_t index) {
 			_ABP_DEBUG_OUT("Checking finished future token...");
 
-			for (uint32_t i = 0; i < verifyTokens.size(); i++)
-				for (uint16_t j = 0; j < verifyTokens[i]->TriggersLength; j++) {
+			// Find the first verify token that's waiting on this token - that's the earliest started one still being verified.
+			ABParserVerifyToken<T>* currentVerifyToken = nullptr;
+			uint32_t j = 0;
 
-					ABParserVerifyToken<T>* currentVerifyToken = verifyTokens[i];
-					ABParserFutureToken<T>* trigger = currentVerifyToken->Triggers[j];
+			ABParserTriggerReference<T> reference = token->FirstReference;
+			while (reference.Token) {
+				ABParserVerifyToken<T>* verifyToken = reference.Token;
+				uint32_t slot = reference.Slot;
+				reference = verifyToken->NextReferences[slot];
 
-					if (trigger == token) {
+				if (verifyToken->IsStopped || verifyToken->TriggersLength == 0 || verifyToken->Triggers[slot] != token)
+					continue;
 
-						// Since this trigger was finished, it must have been this trigger all along, so stop verifying and finalize this trigger!
-						// However, before we finalize this trigger - we need to check if we need verify it against one of the other triggers!
-						if (currentVerifyToken->TriggersLength > 1) {
+				if (!currentVerifyToken || verifyToken->Order < currentVerifyToken->Order) {
+					currentVerifyToken = verifyToken;
+					j = slot;
+				}
+			}
 
-							uint32_t thisLength = trigger->Token->TokenLength;
-							bool areAnyLonger = false;
+			if (!currentVerifyToken) return 0;
 
-							for (uint16_t k = 0; k < currentVerifyToken->TriggersLength; k++) {
+			ABParserFutureToken<T>* trigger = token;
 
-								if (j == k) continue;
+			// Since this trigger was finished, it must have been this trigger all along, so stop verifying and finalize this trigger!
+			// However, before we finalize this trigger - we need to check if we need verify it against one of the other triggers!
+			if (currentVerifyToken->TriggersLength > 1) {
 
-								ABParserFutureToken<T>* currentTrigger = currentVerifyToken->Triggers[k];
-								if (currentTrigger == nullptr) continue;
+				uint32_t thisLength = trigger->Token->TokenLength;
+				bool areAnyLonger = false;
 
-								if (currentTrigger->Token->TokenLength > thisLength) {
-									currentVerifyTriggers.push_back(currentTrigger);
-									currentVerifyTriggerStarts.push_back(currentVerifyToken->TriggerStarts[k]);
-									areAnyLonger = true;
-								}
-							}
+				for (uint32_t k = 0; k < currentVerifyToken->TriggersLength; k++) {
 
-							if (areAnyLonger) {
+					if (j == k) continue;
 
-								// Now, we need to verify THIS trigger, so, to do that we need to stop verifying the existing token, and start verifying this trigger.
-								StopVerify(i);
-								StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(trigger, false, currentVerifyToken->TriggerStarts[j], GenerateVerifyTrailing())));
+					ABParserFutureToken<T>* currentTrigger = currentVerifyToken->Triggers[k];
+					if (currentTrigger == nullptr) continue;
 
-								return -1;
-							}
-						}
-
-						StopAllVerify();
-						return static_cast<int>(FinalizeToken(trigger, index, buildUp, buildUpLength, true));
+					if (currentTrigger->Token->TokenLength > thisLength) {
+						currentVerifyTriggers.push_back(currentTrigger);
+						currentVerifyTriggerStarts.push_back(currentVerifyToken->TriggerStarts[k]);
+						areAnyLonger = true;
 					}
 				}
 
-			return 0;
-		}
+				if (areAnyLonger) {
 
-		ABParserResult FinalizeNextVerifyToken() {
+					// Now, we need to verify THIS trigger, so, to do that we need to stop verifying the existing token, and start verifying this trigger.
+					for (uint32_t i = 0; i < verifyTokens.size(); i++)
+						if (verifyTokens[i] == currentVerifyToken) {
+							StopVerify(i);
+							break;
+						}
 
-			// We're adding "1" whenever we use the "TrailingBuildUp" because its first character is the last character of the token.
-			_ABP_DEBUG_OUT("Finalizing verify original token...");
+					StartVerify(LoadCurrentTriggersInto(new ABParserVerifyToken<T>(trigger, false, currentVerifyToken->TriggerStarts[j])));
 
-			// Determine the next item to finalize.
-			ABParserVerifyToken<T>* nextItem = nullptr;
-			for (; finalizingVerifyTokensCurrentEventToken < verifyTokens.size(); finalizingVerifyTokensCurrentEventToken++)
-				if (verifyTokens[finalizingVerifyTokensCurrentEventToken]->TriggersLength == 0) {
-					nextItem = verifyTokens[finalizingVerifyTokensCurrentEventToken];
-					break;
+					return -1;
 				}
+			}
 
-			if (!nextItem) {
-
-				isFinalizingVerifyTokens = false;
+			StopAllVerify();
+			return static_cast<int>(FinalizeToken(trigger, index));
+		}
 
-				// Set the buildUp to the trailing of the last token so that it can be used as the leading of the next token.
-				buildUp = lastVerifyToken->TrailingBuildUp + 1;
-				buildUpLength = lastVerifyToken->TrailingBuildUpLength - 1;
-				finalizingVerifyTokensCurrentEventToken = 0;
-				lastVerifyToken = nullptr;
+		ABParserResult FinalizeNextVerifyToken() {
+			_ABP_DEBUG_OUT("Finalizing verify original token...");
+			_ABP_STAT_TIME(FinalizeVerifyTokensTime);
 
-				// The character we were on when we started never got added to the buildUp, so, we'll add it to the buildUp now.
-				StopAllVerify();
-				AddCharToBuildUp(Text[InternalPosition - 1]);
+			// Finalize the next token that got completed, and remove it. Finalizing it stops anything else that started inside of it, which may complete more tokens after it.
+			for (uint32_t i = 0; i < verifyTokens.size(); i++)
+				if (verifyTokens[i]->TriggersLength == 0) {
+					ABParserVerifyToken<T>* nextItem = verifyTokens[i];
 
-				return ABParserResult::None;
-			}
+					_ABP_STAT_INC(VerifyTokensFinalized);
+					StopVerify(i);
+					return FinalizeToken(nextItem);
+				}
 
-			// Finalize the next token, and remove it.
-			bool isFirst = lastVerifyToken == nullptr;
-			ABParserResult result = FinalizeToken(verifyTokens.front(), isFirst ? buildUp : lastVerifyToken->TrailingBuildUp + 1, isFirst ? buildUpLength : lastVerifyToken->TrailingBuildUpLength - 1, false);
-			lastVerifyToken = nextItem;
-			StopVerify(finalizingVerifyTokensCurrentEventToken);
+			// There's nothing left to finalize, so go back to the character we were on when we started, so that the rest of it can get processed.
+			isFinalizingVerifyTokens = false;
+			if (finishingCharAfterVerifying)
+				InternalPosition--;
 
-			return result;
+			return ABParserResult::None;
 		}
 
 		ABParserVerifyToken<T>* LoadCurrentTriggersInto(ABParserVerifyToken<T>* token) {
-			token->TriggersLength = (uint16_t)currentVerifyTriggers.size();
+			token->TriggersLength = token->RemainingTriggers = (uint32_t)currentVerifyTriggers.size();
+			token->Order = nextVerifyOrder++;
 
 			ABParserFutureToken<T>** triggers = token->Triggers = new ABParserFutureToken<T> * [token->TriggersLength];
 			uint32_t* triggerStarts = token->TriggerStarts = new uint32_t[token->TriggersLength];
+			ABParserTriggerReference<T>* nextReferences = token->NextReferences = new ABParserTriggerReference<T>[token->TriggersLength];
 
 			// Copy across the values.
-			for (uint16_t i = 0; i < token->TriggersLength; i++)
+			for (uint32_t i = 0; i < token->TriggersLength; i++)
 				triggers[i] = currentVerifyTriggers[i];
-			for (uint16_t i = 0; i < token->TriggersLength; i++)
+			for (uint32_t i = 0; i < token->TriggersLength; i++)
 				triggerStarts[i] = currentVerifyTriggerStarts[i];
 
+			// Add this token onto the chain of each trigger, so the trigger can find it again once it gets disabled or finished.
+			for (uint32_t i = 0; i < token->TriggersLength; i++) {
+				nextReferences[i] = triggers[i]->FirstReference;
+				triggers[i]->FirstReference.Token = token;
+				triggers[i]->FirstReference.Slot = i;
+			}
+
 			// Finally, return our new modified verify token!
 			return token;
 
 		}
 
-		T* GenerateVerifyTrailing() {
-			return &buildUpStart[InternalPosition + 1];
-		}
-
 		// FINALIZE
-		ABParserResult FinalizeToken(ABParserVerifyToken<T>* verifyToken, T* buildUpToUse, uint32_t buildUpToUseLength, bool resetBuildUp) {
+		ABParserResult FinalizeToken(ABParserVerifyToken<T>* verifyToken) {
 			if (verifyToken->IsSingleChar)
-				return FinalizeToken((SingleCharToken<T>*)verifyToken->Token, verifyToken->Start, buildUpToUse, buildUpToUseLength, resetBuildUp);
+				return FinalizeToken((SingleCharToken<T>*)verifyToken->Token, verifyToken->Start);
 			else
-				return FinalizeToken((ABParserFutureToken<T>*)verifyToken->Token, verifyToken->Start, buildUpToUse, buildUpToUseLength, resetBuildUp);
+				return FinalizeToken((ABParserFutureToken<T>*)verifyToken->Token, verifyToken->Start);
 		}
 
-		ABParserResult FinalizeToken(SingleCharToken<T>* token, uint32_t index, T* buildUpToUse, uint32_t buildUpToUseLength, bool resetBuildUp) {
+		ABParserResult FinalizeToken(SingleCharToken<T>* token, uint32_t index) {
 
 			_ABP_DEBUG_OUT("Finalizing single-char token");
 
-			PrepareLeadingAndTrailing(index, buildUpToUse, buildUpToUseLength, resetBuildUp, false);
+			if (!IsTokenSubscribed(token->MixedIdx))
+				return PassUnsubscribedToken((ABParserInternalToken<T>*)token, index, 1);
+
+			PrepareLeadingAndTrailing(index, false);
 			return QueueTokenAndReturnFinalizeResult((ABParserInternalToken<T>*)token, index, 1);
 		}
 
-		ABParserResult FinalizeToken(ABParserFutureToken<T>* token, uint32_t index, T* buildUpToUse, uint32_t buildUpToUseLength, bool resetBuildUp) {
+		ABParserResult FinalizeToken(ABParserFutureToken<T>* token, uint32_t index) {
 
 			_ABP_DEBUG_OUT("Finalizing multi-char token");
 
-			PrepareLeadingAndTrailing(index, buildUpToUse, buildUpToUseLength, resetBuildUp, false);
+			if (!IsTokenSubscribed(token->Token->MixedIdx))
+				return PassUnsubscribedToken((ABParserInternalToken<T>*)token->Token, index, token->LengthInText);
+
+			PrepareLeadingAndTrailing(index, false);
 			return QueueTokenAndReturnFinalizeResult((ABParserInternalToken<T>*)token->Token, index, token->LengthInText);
 		}
 
+		ABParserResult FinalizeToken(RunToken<T>* token, uint32_t index, uint32_t length) {
+
+			_ABP_DEBUG_OUT("Finalizing run token");
+
+			if (!IsTokenSubscribed(token->MixedIdx))
+				return PassUnsubscribedToken((ABParserInternalToken<T>*)token, index, length);
+
+			PrepareLeadingAndTrailing(index, false);
+			return QueueTokenAndReturnFinalizeResult((ABParserInternalToken<T>*)token, index, length);
+		}
+
+		void ApplyLimitRules(ABParserLimitRules<T>* rules) {
+			if (rules->ExitsTokenLimit && !CurrentEventTokenLimits.empty() && CurrentEventTokenLimits.top() == rules->ExitsTokenLimit) ExitTokenLimit();
+			else if (rules->EntersTokenLimit) EnterTokenLimit(rules->EntersTokenLimit);
+
+			if (rules->ExitsTriviaLimit && !CurrentTriviaLimits.empty() && CurrentTriviaLimits.top() == rules->ExitsTriviaLimit) ExitTriviaLimit();
+			else if (rules->EntersTriviaLimit) EnterTriviaLimit(rules->EntersTriviaLimit);
+		}
+
 		ABParserResult QueueTokenAndReturnFinalizeResult(ABParserInternalToken<T>* token, uint32_t index, uint32_t lengthInText) {
 
 			bool firstToken = CurrentEventToken == nullptr;
@@ -670,9 +1217,11 @@ namespace abparser {
 			CurrentEventToken = token;
 			CurrentEventTokenLengthInText = lengthInText;
 			CurrentEventTokenStart = index;
+			triviaStart = index + lengthInText;
+			skippedSpans.clear();
 
-			// Now that we've finalized this token, stop any futureTokens we had before.
-			futureTokensHead = InternalPosition + 1;
+			StopTokensBefore(index + lengthInText);
+			if (token->LimitRules) ApplyLimitRules(token->LimitRules);
 
 			if (firstToken)
 				return ABParserResult::FirstBeforeTokenProcessed;
@@ -680,52 +1229,79 @@ namespace abparser {
 				return ABParserResult::OnThenBeforeTokenProcessed;
 		}
 
-		void PrepareLeadingAndTrailing(uint32_t tokenStart, T* buildUpToUse, uint32_t buildUpToUseLength, bool resetBuildUp, bool isEnd) {
+		// This is still a token in the text, but nobody wants to hear about it - so it only affects what comes after it.
+		ABParserResult PassUnsubscribedToken(ABParserInternalToken<T>* token, uint32_t index, uint32_t lengthInText) {
+			_ABP_DEBUG_OUT("Passing over unsubscribed token");
+
+			if (UnsubscribedTokens == ABParserUnsubscribedTokens::Skip) {
+				skippedSpans.push_back(index);
+				skippedSpans.push_back(index + lengthInText);
+			}
+
+			StopTokensBefore(index + lengthInText);
+			if (token->LimitRules) ApplyLimitRules(token->LimitRules);
+
+			passedUnsubscribedToken = true;
+			return ABParserResult::None;
+		}
+
+		// Now that we've finalized a token, nothing that started before its end can be a token anymore - so stop any verify tokens and futureTokens that did.
+		void StopTokensBefore(uint32_t end) {
+			for (uint32_t i = 0; i < verifyTokens.size();)
+				if (verifyTokens[i]->Start < end) StopVerify(i);
+				else i++;
+
+			for (; futureTokensHead < end; futureTokensHead++)
+				for (uint32_t j = 0; !futureTokens[futureTokensHead][j].EndOfArray; j++)
+					if (!futureTokens[futureTokensHead][j].CollectionComplete) DisableFutureToken(&futureTokens[futureTokensHead][j]);
+		}
+
+		// Finds the trivia that comes before "tokenStart" (or the end of the text) - only where it is, when locating tokens, otherwise copying it out too.
+		void PrepareLeadingAndTrailing(uint32_t tokenStart, bool isEnd) {
 			_ABP_DEBUG_OUT("Preparing leading and trailing for token.");
 
-			// We need to work out how much of the buildUp is what we really want, as the buildUp will contain this token or part of it at the end, and we need to trim that off.
-			uint32_t trailingLength;
-			if (isEnd)
-				trailingLength = buildUpToUseLength;
-			else if (CurrentEventToken)
-				trailingLength = tokenStart - (CurrentEventTokenStart + CurrentEventTokenLengthInText);
-			else
-				trailingLength = tokenStart;
+			// The trivia is everything between the end of the last token and the start of this one (or the end of the text).
+			uint32_t trailingLength = (isEnd ? TextLength : tokenStart) - triviaStart;
+			T* trivia = Text + triviaStart;
 
+			CurrentTriviaStart = triviaStart;
+			CurrentTriviaSpanLength = trailingLength;
+			CurrentTriviaSpanLimit = CurrentTriviaLimits.empty() ? nullptr : CurrentTriviaLimits.top();
 			CurrentTriviaLength = 0;
+			CurrentTriviaSkipped = skippedSpans;
 
-			// Copy the buildUp into the final trivia, but excluding any of the trivia limit characters.
-			if (CurrentTriviaLimits.empty())
-				for (uint32_t i = 0; i < trailingLength; i++)
-					CurrentTrivia[CurrentTriviaLength++] = buildUpToUse[i];
-			else {
-
-				TriviaLimit<T>* limit = CurrentTriviaLimits.top();
+			if (LocateOnly) {
+				CurrentTriviaIsSpan = false;
+				return;
+			}
 
-				for (uint32_t i = 0; i < trailingLength; i++) {
-					if (ArrContainsChar(limit->Data, limit->DataLength, buildUpToUse[i])) {
-						if (limit->IsWhitelist) CurrentTrivia[CurrentTriviaLength++] = buildUpToUse[i];
-						continue;
-					}
+			// Anything too long for the buffer is just left where it is in the text.
+			CurrentTriviaIsSpan = trailingLength > TriviaCapacity;
+			if (CurrentTriviaIsSpan) return;
 
-					if (!limit->IsWhitelist) CurrentTrivia[CurrentTriviaLength++] = buildUpToUse[i];
-				}
+			// Copy it into the final trivia, but excluding any of the trivia limit characters (or skipped tokens).
+			if (CurrentTriviaLimits.empty() && CurrentTriviaSkipped.empty())
+				for (uint32_t i = 0; i < trailingLength; i++)
+					CurrentTrivia[CurrentTriviaLength++] = trivia[i];
+			else {
+				uint32_t offset = 0;
+				CurrentTriviaLength = ReadTriviaChunk(triviaStart, trailingLength, CurrentTriviaSpanLimit, offset, CurrentTrivia, TriviaCapacity, &CurrentTriviaSkipped);
 			}
 
 			CurrentTrivia[CurrentTriviaLength] = 0;
-
-			if (resetBuildUp)
-				buildUpLength = 0;
+			_ABP_STAT_ADD(TriviaBytesCopied, (uint64_t)CurrentTriviaLength * sizeof(T));
 		}
 
 		// HELPERS
-		void AddFutureToken(MultiCharToken<T>* token, uint16_t currentLength) {
-			futureTokens[InternalPosition][currentLength].Reset(token);
-			futureTokens[InternalPosition][currentLength].LengthInText++;
-			futureTokens[InternalPosition][currentLength].NoOfCharactersMatched++;
+		void AddFutureToken(ABParserFutureToken<T>* futureToken, MultiCharToken<T>* token) {
+			_ABP_STAT_INC(FutureTokensCreated);
+			futureToken->Reset(token);
+			futureToken->LengthInText++;
+			futureToken->NoOfCharactersMatched++;
 		}
 
 		void DisableFutureToken(ABParserFutureToken<T>* futureToken) {
+			_ABP_STAT_INC(FutureTokensDisabled);
 			futureToken->CollectionComplete = true;
 			if (verifyTokens.size())
 				CheckDisabledFutureToken(futureToken);
@@ -734,22 +1310,41 @@ namespace abparser {
 		void ResetCurrentEventTokens() {
 			singleCharCurrentTokens = Configuration->SingleCharTokens;
 			singleCharCurrentTokensLength = Configuration->NumberOfSingleCharTokens;
+			singleCharCurrentStarts = &Configuration->SingleCharStarts;
+
+			SetCurrentMultiCharTokens(Configuration->MultiCharTokens, Configuration->NumberOfMultiCharTokens, Configuration->MultiCharTrie);
+			multiCharCurrentStarts = &Configuration->MultiCharStarts;
 
-			multiCharCurrentTokens = Configuration->MultiCharTokens;
-			multiCharCurrentTokensLength = Configuration->NumberOfMultiCharTokens;
+			runCurrentTokens = Configuration->RunTokens;
+			runCurrentTokensLength = Configuration->NumberOfRunTokens;
+			runCurrentStarts = &Configuration->RunStarts;
+
+			currentTokenStarts = &Configuration->TokenStarts;
 		}
 
 		void SetCurrentEventTokens(TokenLimit<T>* limit) {
 			singleCharCurrentTokens = limit->SingleCharTokens;
 			singleCharCurrentTokensLength = limit->NumberOfSingleCharTokens;
+			singleCharCurrentStarts = &limit->SingleCharStarts;
+
+			SetCurrentMultiCharTokens(limit->MultiCharTokens, limit->NumberOfMultiCharTokens, limit->MultiCharTrie);
+			multiCharCurrentStarts = &limit->MultiCharStarts;
+
+			runCurrentTokens = limit->RunTokens;
+			runCurrentTokensLength = limit->NumberOfRunTokens;
+			runCurrentStarts = &limit->RunStarts;
+
+			currentTokenStarts = &limit->TokenStarts;
+		}
 
-			multiCharCurrentTokens = limit->MultiCharTokens;
-			multiCharCurrentTokensLength = limit->NumberOfMultiCharTokens;
+		void SetCurrentMultiCharTokens(MultiCharToken<T>** tokens, uint32_t numberOfTokens, ABParserTokenTrie<T>* trie) {
+			multiCharCurrentTrie = trie;
+			multiCharCurrentTokens = trie ? trie->UnindexedTokens.data() : tokens;
+			multiCharCurrentTokensLength = trie ? (uint32_t)trie->UnindexedTokens.size() : numberOfTokens;
 		}
 
 		void AddVerifyToken(ABParserVerifyToken<T>* token) {
 			verifyTokens.push_back(token);
-			currentVerifyToken = token;
 		}
 
 		// LIMITS:
@@ -761,6 +1356,33 @@ namespace abparser {
 			return false;
 		}
 
+		// How many code units the character at "pos" takes up - this is always 1 unless we're in UTF-8 mode.
+		uint8_t CharacterLengthAt(T* text, uint32_t pos, uint32_t length) {
+			if (!Configuration->IsUTF8) return 1;
+
+			uint8_t characterLength = UTF8CharacterLength((uint8_t)text[pos]);
+			return characterLength > length - pos ? (uint8_t)(length - pos) : characterLength;
+		}
+
+		bool SetContainsCharacter(T* set, uint16_t setSize, T* ch, uint8_t chLength) {
+			if (!Configuration->IsUTF8) return ArrContainsChar(set, setSize, *ch);
+			return UTF8SetContains(set, setSize, ch, chLength);
+		}
+
+		// Whether there aren't any tokens being collected or verified. The last character's future tokens only get trimmed off when the next character comes along, so that's fine as long as it didn't start any.
+		bool IsIdle() {
+			if (futureTokensHead != futureTokensTail && (futureTokensHead + 1 != futureTokensTail || !futureTokens[futureTokensHead][0].EndOfArray)) return false;
+			return verifyTokens.empty() && !isFinalizingVerifyTokens && !finishingCharAfterVerifying;
+		}
+
+		// How much of the text from "start" a remembered piece can cover. In UTF-8 mode, the last few bytes are left out, as characters that get cut off by the end of the text are treated differently.
+		uint32_t GetMemoLength(uint32_t start) {
+			uint32_t length = TextLength - start;
+			if (!Configuration->IsUTF8) return length;
+
+			return length > 3 ? length - 3 : 0;
+		}
+
 		ABParserResult TriggerOnFirstUnlimitedCharacterProcessed() {
 			notEncounteredFirstUnlimitedChar = false;
 			return ABParserResult::OnFirstUnlimitedCharacterProcessed;
@@ -0,0 +1,257 @@
+#ifndef _ABPARSER_INCLUDE_CACHE_H
+#define _ABPARSER_INCLUDE_CACHE_H
+#include "ABParser.h"
+#include <filesystem>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <typeinfo>
+
+namespace abparser {
+
+	// Keeps the token streams of previous parses on disk, so parsing the same text with the same configuration again (even in another process) just replays the events instead of running the parser.
+	// Every entry is a separate file named after a hash of the text and the configuration. They're written to a temporary file and renamed into place, so other processes sharing the directory only
+	// ever see whole entries. Any entry that can't be read properly is just treated as a miss.
+	// Configurations with trivia limits are never cached, as the trivia can't be rebuilt from a token stream - those always run the parser like normal. Neither are parsers that aren't
+	// subscribed to every token, as the entries are shared by everything using the same configuration.
+	// Events can enter and exit limits, which changes where the tokens are found, so the entries are also kept by the type of parser. If the same type of parser can do that differently
+	// (e.g. depending on some setting of its own), give each way of doing it a different "Salt".
+	template<typename T, typename U = char>
+	class ABParserCache {
+	public:
+		std::filesystem::path Directory;
+
+		// Once the entries add up to more than this many bytes, the least recently used ones get removed.
+		uintmax_t MaxSize;
+
+		// Goes into the name of every entry, so parsers with different salts never share entries.
+		std::string Salt;
+
+		ABParserCache(const std::filesystem::path& directory, uintmax_t maxSize = 64 << 20) {
+			Directory = directory;
+			MaxSize = maxSize;
+
+			std::error_code error;
+			std::filesystem::create_directories(Directory, error);
+		}
+
+		// Runs "parser" on the text it's been given, the same as "ABParser::Start", but from the cache if it can. Returns whether it came from the cache.
+		bool Start(ABParser<T, U>& parser) {
+			ABParserConfiguration<T, U>* configuration = parser.Base.Configuration;
+
+			if (!configuration->TriviaLimits.empty() || parser.Base.HasUnsubscribedTokens()) {
+				parser.Start();
+				return false;
+			}
+
+			std::filesystem::path entryPath = Directory / GetEntryName(parser);
+
+			std::vector<uint8_t> data;
+			if (ReadEntry(entryPath, data)) {
+				ABParserTokenStreamReader reader(data.data(), data.size());
+
+				if (IsEntryValid(reader, configuration, parser.Base.TextLength)) {
+
+					// The modification time is used as the last time an entry was used, so the eviction knows which ones to remove first.
+					std::error_code error;
+					std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+					ABParserTokenStreamReader replay(data.data(), data.size());
+					parser.StartReplaying(replay);
+					return true;
+				}
+			}
+
+			// A parse that was abandoned part-way through doesn't have a whole stream to keep.
+			ABParserTokenStreamWriter writer;
+			if (parser.StartRecording(writer) && WriteEntry(entryPath, writer.Data))
+				Evict();
+
+			return false;
+		}
+
+		// Removes the least recently used entries until they all fit within "MaxSize".
+		void Evict() {
+			std::vector<Entry> entries;
+			uintmax_t totalSize = 0;
+
+			std::error_code error;
+			for (std::filesystem::directory_iterator it(Directory, error), end; !error && it != end; it.increment(error)) {
+				if (it->path().extension() != ".abpt") continue;
+
+				Entry entry;
+				entry.Path = it->path();
+				entry.Size = it->file_size(error);
+				if (error) { error.clear(); continue; }
+
+				entry.LastUsed = it->last_write_time(error);
+				if (error) { error.clear(); continue; }
+
+				totalSize += entry.Size;
+				entries.push_back(entry);
+			}
+
+			if (totalSize <= MaxSize) return;
+
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+
+			// Another process might have already removed some of these, which is fine - they're gone either way.
+			for (size_t i = 0; i < entries.size() && totalSize > MaxSize; i++) {
+				std::filesystem::remove(entries[i].Path, error);
+				totalSize -= entries[i].Size;
+			}
+		}
+
+		// A hash of everything in the configuration that affects where the tokens are found.
+		static uint64_t GetConfigurationFingerprint(ABParserConfiguration<T, U>* configuration) {
+			uint64_t hash = FNVOffset;
+
+			uint32_t numberOfTokens = configuration->NumberOfTokens;
+			hash = Hash(hash, &numberOfTokens, sizeof(numberOfTokens));
+			hash = Hash(hash, &configuration->IsUTF8, sizeof(configuration->IsUTF8));
+
+			// A trie can give some tokens sooner (see "ABParserConfiguration::TokenTrieThreshold").
+			bool usesTokenTrie = configuration->MultiCharTrie != nullptr;
+			hash = Hash(hash, &usesTokenTrie, sizeof(usesTokenTrie));
+
+			uint8_t characterSize = sizeof(T);
+			hash = Hash(hash, &characterSize, sizeof(characterSize));
+
+			for (uint32_t i = 0; i < numberOfTokens; i++) {
+				ABParserToken<T, U>& token = configuration->Tokens[i];
+
+				hash = Hash(hash, &token.DataLength, sizeof(token.DataLength));
+				hash = Hash(hash, &token.IgnoreCase, sizeof(token.IgnoreCase));
+				hash = Hash(hash, token.Data, token.DataLength * sizeof(T));
+				hash = Hash(hash, &token.DetectionLimitSize, sizeof(token.DetectionLimitSize));
+				hash = Hash(hash, token.DetectionLimit, token.DetectionLimitSize * sizeof(T));
+
+				hash = Hash(hash, &token.LimitsLength, sizeof(token.LimitsLength));
+				for (uint16_t j = 0; j < token.LimitsLength; j++)
+					hash = HashName(hash, token.Limits[j]);
+
+				hash = HashName(hash, token.EntersTokenLimit);
+				hash = HashName(hash, token.ExitsTokenLimit);
+				hash = HashName(hash, token.EntersTriviaLimit);
+				hash = HashName(hash, token.ExitsTriviaLimit);
+
+				hash = Hash(hash, &token.NumberOfRunRanges, sizeof(token.NumberOfRunRanges));
+				hash = Hash(hash, token.RunRanges, (size_t)token.NumberOfRunRanges * 2 * sizeof(T));
+				hash = Hash(hash, &token.MinRunLength, sizeof(token.MinRunLength));
+				hash = Hash(hash, &token.MaxRunLength, sizeof(token.MaxRunLength));
+			}
+
+			return hash;
+		}
+
+	private:
+		static const uint64_t FNVOffset = 0xCBF29CE484222325;
+		static const uint64_t FNVPrime = 0x100000001B3;
+
+		class Entry {
+		public:
+			std::filesystem::path Path;
+			uintmax_t Size = 0;
+			std::filesystem::file_time_type LastUsed;
+		};
+
+		static uint64_t Hash(uint64_t hash, const void* data, size_t size) {
+			const uint8_t* bytes = (const uint8_t*)data;
+
+			for (size_t i = 0; i < size; i++) {
+				hash ^= bytes[i];
+				hash *= FNVPrime;
+			}
+
+			return hash;
+		}
+
+		// A missing name hashes differently to an empty one.
+		static uint64_t HashName(uint64_t hash, const std::basic_string<U>* name) {
+			uint32_t size = name ? (uint32_t)name->size() : 0xFFFFFFFF;
+			hash = Hash(hash, &size, sizeof(size));
+
+			if (name) hash = Hash(hash, name->data(), name->size() * sizeof(U));
+			return hash;
+		}
+
+		std::string GetEntryName(ABParser<T, U>& parser) {
+			ABParserBase<T, U>& base = parser.Base;
+			uint64_t textHash = Hash(FNVOffset, base.Text, base.TextLength * sizeof(T));
+
+			// What the events might do.
+			const char* parserType = typeid(parser).name();
+			uint64_t parserHash = Hash(FNVOffset, parserType, strlen(parserType));
+			parserHash = Hash(parserHash, Salt.data(), Salt.size());
+
+			char name[96];
+			snprintf(name, sizeof(name), "%016llx-%016llx-%016llx-%x.abpt", (unsigned long long)GetConfigurationFingerprint(base.Configuration), (unsigned long long)parserHash,
+				(unsigned long long)textHash, base.TextLength);
+			return name;
+		}
+
+		// Makes sure the whole stream can be read, and all of it fits within this text and configuration, before any events get triggered from it.
+		static bool IsEntryValid(ABParserTokenStreamReader& reader, ABParserConfiguration<T, U>* configuration, uint32_t textLength) {
+			uint32_t numberOfTokens = configuration->NumberOfTokens;
+
+			while (reader.Next())
+				if (reader.TokenIndex >= numberOfTokens || (uint64_t)reader.TokenStart + reader.TokenLength > textLength)
+					return false;
+
+			return reader.IsValid && (uint64_t)reader.EndTriviaStart + reader.EndTriviaLength == textLength;
+		}
+
+		static bool ReadEntry(const std::filesystem::path& path, std::vector<uint8_t>& data) {
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file) return false;
+
+			std::streamoff size = file.tellg();
+			if (size <= 0) return false;
+
+			data.resize((size_t)size);
+			file.seekg(0);
+			return (bool)file.read((char*)data.data(), size);
+		}
+
+		static bool WriteEntry(const std::filesystem::path& path, std::vector<uint8_t>& data) {
+			static const uint32_t processTag = std::random_device()();
+			static std::atomic<uint32_t> nextTemporary(0);
+
+			// Unique to this write, so nothing else (in this process or any other) can be writing to the same temporary file.
+			std::filesystem::path temporaryPath = path;
+			temporaryPath += "." + std::to_string(processTag) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "-" +
+				std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" + std::to_string(nextTemporary++) + ".tmp";
+
+			std::error_code error;
+
+			{
+				std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+				if (!file) return false;
+
+				file.write((const char*)data.data(), data.size());
+				if (!file) {
+					file.close();
+					std::filesystem::remove(temporaryPath, error);
+					return false;
+				}
+			}
+
+			// If another process got there first, this just replaces their entry with an identical one.
+			std::filesystem::rename(temporaryPath, path, error);
+			if (error) {
+				std::filesystem::remove(temporaryPath, error);
+				return false;
+			}
+
+			return true;
+		}
+	};
+}
+#endif
@@ -8,6 +8,8 @@
 #include <vector>
 #include <cstdarg>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
 
 namespace abparser {
 	template<typename T, typename U = char>
@@ -25,6 +27,21 @@ namespace abparser {
 		T* Data;
 		uint16_t DataLength;
 
+		// Whether this token should match the text no matter what case it's in. The text itself is never changed, so the positions still line up with it.
+		bool IgnoreCase;
+
+		// The names of the limits this token enters or exits by itself when it's found, instead of the events doing it - see "ABParserLimitRules". Any of these can be null.
+		const std::basic_string<U>* EntersTokenLimit;
+		const std::basic_string<U>* ExitsTokenLimit;
+		const std::basic_string<U>* EntersTriviaLimit;
+		const std::basic_string<U>* ExitsTriviaLimit;
+
+		// Only set for run tokens (see "SetRun") - pairs of the first and last character in each range.
+		T* RunRanges;
+		uint16_t NumberOfRunRanges;
+		uint32_t MinRunLength;
+		uint32_t MaxRunLength;
+
 		ABParserToken() {
 			Name = nullptr;
 			Data = nullptr;
@@ -34,6 +51,65 @@ namespace abparser {
 
 			DetectionLimit = nullptr;
 			DetectionLimitSize = 0;
+
+			IgnoreCase = false;
+
+			EntersTokenLimit = nullptr;
+			ExitsTokenLimit = nullptr;
+			EntersTriviaLimit = nullptr;
+			ExitsTriviaLimit = nullptr;
+
+			RunRanges = nullptr;
+			NumberOfRunRanges = 0;
+			MinRunLength = 1;
+			MaxRunLength = 0;
+		}
+
+		ABParserToken<T, U>* SetIgnoreCase(bool ignoreCase) {
+			IgnoreCase = ignoreCase;
+			return this;
+		}
+
+		ABParserToken<T, U>* SetEntersTokenLimit(const std::basic_string<U>& limitName) {
+			SetLimitRule(EntersTokenLimit, limitName);
+			return this;
+		}
+
+		ABParserToken<T, U>* SetExitsTokenLimit(const std::basic_string<U>& limitName) {
+			SetLimitRule(ExitsTokenLimit, limitName);
+			return this;
+		}
+
+		ABParserToken<T, U>* SetEntersTriviaLimit(const std::basic_string<U>& limitName) {
+			SetLimitRule(EntersTriviaLimit, limitName);
+			return this;
+		}
+
+		ABParserToken<T, U>* SetExitsTriviaLimit(const std::basic_string<U>& limitName) {
+			SetLimitRule(ExitsTriviaLimit, limitName);
+			return this;
+		}
+
+		// Makes this a run token instead - any run of characters from the given ranges, like "[0-9]+", so handlers don't need to go through the trivia again to find things
+		// like numbers or identifiers. "ranges" is pairs of the first and last character in each range (both included), and the run has to be at least "minLength" long, and is
+		// cut off at "maxLength" (0 for no maximum). "Data" isn't used for these. In UTF-8 the ranges are of bytes.
+		// The run is decided on where it starts: wherever nothing else is being collected or verified, a character in the ranges starts a run, which goes on for as long as
+		// it can (and is a token if it's long enough). It takes priority over any other token that starts in the same place, and nothing else is looked for inside of it.
+		ABParserToken<T, U>* SetRun(const T* ranges, uint16_t numberOfRanges, uint32_t minLength = 1, uint32_t maxLength = 0) {
+			delete[] RunRanges;
+			RunRanges = new T[(size_t)numberOfRanges * 2];
+
+			for (uint32_t i = 0; i < (uint32_t)numberOfRanges * 2; i++)
+				RunRanges[i] = ranges[i];
+
+			NumberOfRunRanges = numberOfRanges;
+			MinRunLength = minLength ? minLength : 1;
+			MaxRunLength = maxLength;
+			return this;
+		}
+
+		bool HasLimitRules() const {
+			return EntersTokenLimit || ExitsTokenLimit || EntersTriviaLimit || ExitsTriviaLimit;
 		}
 
 		ABParserToken<T, U>* SetName(const std::basic_string<U>& name) {
@@ -113,18 +189,56 @@ namespace abparser {
 			return this;
 		}
 
+		// Makes this (a freshly made token) a copy of "other", including everything it points to - so neither of them depend on the other.
+		ABParserToken<T, U>* CopyFrom(const ABParserToken<T, U>& other) {
+			if (other.Name) SetName(*other.Name);
+			if (other.Data) SetData(other.Data, other.DataLength);
+			if (other.DetectionLimit) DirectSetDetectionLimit(other.DetectionLimit, other.DetectionLimitSize);
+
+			if (other.Limits) {
+				LimitsLength = other.LimitsLength;
+				Limits = new const std::basic_string<U>*[LimitsLength];
+
+				for (uint16_t i = 0; i < LimitsLength; i++)
+					Limits[i] = new const std::basic_string<U>(*other.Limits[i]);
+			}
+
+			IgnoreCase = other.IgnoreCase;
+			if (other.EntersTokenLimit) SetEntersTokenLimit(*other.EntersTokenLimit);
+			if (other.ExitsTokenLimit) SetExitsTokenLimit(*other.ExitsTokenLimit);
+			if (other.EntersTriviaLimit) SetEntersTriviaLimit(*other.EntersTriviaLimit);
+			if (other.ExitsTriviaLimit) SetExitsTriviaLimit(*other.ExitsTriviaLimit);
+			if (other.RunRanges) SetRun(other.RunRanges, other.NumberOfRunRanges, other.MinRunLength, other.MaxRunLength);
+			return this;
+		}
+
 		~ABParserToken() {
 			delete Name;
 			delete[] Data;
 
 			if (Limits != nullptr) {
 				for (uint32_t i = 0; i < LimitsLength; i++)
-					delete[] Limits[i];
+					delete Limits[i];
 				delete[] Limits;
 			}
 
 			if (DetectionLimit != nullptr)
 				delete[] DetectionLimit;
+
+			delete EntersTokenLimit;
+			delete ExitsTokenLimit;
+			delete EntersTriviaLimit;
+			delete ExitsTriviaLimit;
+			delete[] RunRanges;
+		}
+
+	private:
+		void SetLimitRule(const std::basic_string<U>*& rule, const std::basic_string<U>& limitName) {
+			if (limitName.size() > 255)
+				throw "Limit Names can only be 255 characters long at a maximum.";
+
+			delete rule;
+			rule = new const std::basic_string<U>(limitName);
 		}
 	};
 
@@ -132,21 +246,100 @@ namespace abparser {
 	class TokenLimit {
 	public:
 		SingleCharToken<T>** SingleCharTokens;
-		uint16_t NumberOfSingleCharTokens;
+		uint32_t NumberOfSingleCharTokens;
 		MultiCharToken<T>** MultiCharTokens;
-		uint16_t NumberOfMultiCharTokens;
+		uint32_t NumberOfMultiCharTokens;
+		RunToken<T>** RunTokens;
+		uint32_t NumberOfRunTokens;
+
+		FirstCharacterTable<T> SingleCharStarts;
+		FirstCharacterTable<T> MultiCharStarts;
+		FirstCharacterTable<T> RunStarts;
+
+		// What any of the tokens (single-char, multi-char or run) can start with.
+		FirstCharacterScanner<T> TokenStarts;
 
-		TokenLimit(uint16_t maximumAmountOfTokens) {
-			SingleCharTokens = new SingleCharToken<T>*[maximumAmountOfTokens];
-			MultiCharTokens = new MultiCharToken<T>*[maximumAmountOfTokens];
+		// Only there if the configuration looks its multi-char tokens up in a trie (see "ABParserConfiguration::TokenTrieThreshold").
+		ABParserTokenTrie<T>* MultiCharTrie;
+
+		TokenLimit() {
+			SingleCharTokens = nullptr;
+			MultiCharTokens = nullptr;
 			NumberOfSingleCharTokens = 0;
 			NumberOfMultiCharTokens = 0;
+			RunTokens = nullptr;
+			NumberOfRunTokens = 0;
+			MultiCharTrie = nullptr;
+		}
+
+		// While the configuration is being built we don't know how many tokens will end up in this limit, so they're collected here first.
+		void AddToken(ABParserInternalToken<T>* token, bool isSingleChar) {
+			if (token->IsRun())
+				unfinalizedRunTokens.push_back((RunToken<T>*)token);
+			else if (isSingleChar)
+				unfinalizedSingleCharTokens.push_back((SingleCharToken<T>*)token);
+			else
+				unfinalizedMultiCharTokens.push_back((MultiCharToken<T>*)token);
+		}
+
+		// Moves all of the tokens collected into arrays that are exactly the right size, and builds up the tables used to quickly find the start of a token. If this limit was in an earlier
+		// version of the configuration that had a trie, "previousTrie" is that, and the new one is made from it (see "ABParserTokenTrie").
+		void Finalize(bool useTrie, const ABParserTokenTrie<T>* previousTrie = nullptr, const std::vector<MultiCharToken<T>*>* replacements = nullptr) {
+			delete[] SingleCharTokens;
+			delete[] MultiCharTokens;
+			delete[] RunTokens;
+			delete MultiCharTrie;
+
+			NumberOfSingleCharTokens = (uint32_t)unfinalizedSingleCharTokens.size();
+			NumberOfMultiCharTokens = (uint32_t)unfinalizedMultiCharTokens.size();
+			NumberOfRunTokens = (uint32_t)unfinalizedRunTokens.size();
+
+			SingleCharTokens = new SingleCharToken<T>*[NumberOfSingleCharTokens];
+			MultiCharTokens = new MultiCharToken<T>*[NumberOfMultiCharTokens];
+			RunTokens = new RunToken<T>*[NumberOfRunTokens];
+
+			SingleCharStarts.Clear();
+			MultiCharStarts.Clear();
+			RunStarts.Clear();
+			TokenStarts.Clear();
+
+			for (uint32_t i = 0; i < NumberOfSingleCharTokens; i++) {
+				SingleCharTokens[i] = unfinalizedSingleCharTokens[i];
+				SingleCharStarts.Add(SingleCharTokens[i]->TokenChar, SingleCharTokens[i]->IgnoreCase);
+				TokenStarts.Add(SingleCharTokens[i]->TokenChar, SingleCharTokens[i]->IgnoreCase);
+			}
+
+			for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++) {
+				MultiCharTokens[i] = unfinalizedMultiCharTokens[i];
+				MultiCharStarts.Add(MultiCharTokens[i]->TokenContents[0], MultiCharTokens[i]->IgnoreCase);
+				TokenStarts.Add(MultiCharTokens[i]->TokenContents[0], MultiCharTokens[i]->IgnoreCase);
+			}
+
+			for (uint32_t i = 0; i < NumberOfRunTokens; i++) {
+				RunTokens[i] = unfinalizedRunTokens[i];
+				RunTokens[i]->AddStartsTo(RunStarts);
+				RunTokens[i]->AddStartsTo(TokenStarts);
+			}
+
+			if (!useTrie) MultiCharTrie = nullptr;
+			else if (previousTrie) MultiCharTrie = new ABParserTokenTrie<T>(*previousTrie, *replacements, MultiCharTokens, NumberOfMultiCharTokens);
+			else MultiCharTrie = new ABParserTokenTrie<T>(MultiCharTokens, NumberOfMultiCharTokens);
+
+			std::vector<SingleCharToken<T>*>().swap(unfinalizedSingleCharTokens);
+			std::vector<MultiCharToken<T>*>().swap(unfinalizedMultiCharTokens);
+			std::vector<RunToken<T>*>().swap(unfinalizedRunTokens);
 		}
 
 		~TokenLimit() {
 			delete[] SingleCharTokens;
 			delete[] MultiCharTokens;
+			delete[] RunTokens;
+			delete MultiCharTrie;
 		}
+	private:
+		std::vector<SingleCharToken<T>*> unfinalizedSingleCharTokens;
+		std::vector<MultiCharToken<T>*> unfinalizedMultiCharTokens;
+		std::vector<RunToken<T>*> unfinalizedRunTokens;
 	};
 
 	template<typename T>
@@ -196,26 +389,224 @@ namespace abparser {
 	class ABParserConfiguration {
 	public:
 		SingleCharToken<T>** SingleCharTokens;
-		uint16_t NumberOfSingleCharTokens;
+		uint32_t NumberOfSingleCharTokens;
 		MultiCharToken<T>** MultiCharTokens;
-		uint16_t NumberOfMultiCharTokens;
+		uint32_t NumberOfMultiCharTokens;
+		RunToken<T>** RunTokens;
+		uint32_t NumberOfRunTokens;
+
+		FirstCharacterTable<T> SingleCharStarts;
+		FirstCharacterTable<T> MultiCharStarts;
+		FirstCharacterTable<T> RunStarts;
+
+		// What any of the tokens (single-char, multi-char or run) can start with.
+		FirstCharacterScanner<T> TokenStarts;
+
+		// For every multi-char token, one bit for each position inside of it, for each of the other multi-char tokens - set if the other token's contents can be found starting there.
+		// This only depends on the tokens, so it's worked out once here instead of comparing the contents each time a token finishes. It grows with the square of the number of tokens,
+		// so it isn't made when they're looked up in a trie - the contents just get compared instead.
+		uint64_t* MultiCharContainment;
+
+		// Once there are at least this many multi-char tokens, the ones that start at each position are looked up in a trie (in the token limits too), instead of checking every one of them.
+		// With a trie, a token only gets started if all of it is there, so a token inside of one that turns out not to be there is given straight away, rather than once that one stops
+		// matching. That can change what gets found if the limits change in between (through the events or limit rules), so smaller configurations don't use it. This needs setting before "Init".
+		uint32_t TokenTrieThreshold;
+
+		// Only there if the multi-char tokens are looked up in a trie (see "TokenTrieThreshold").
+		ABParserTokenTrie<T>* MultiCharTrie;
+
+		// Whether the text, tokens and limits are all UTF-8 (so "T" should be a single byte). Tokens are still matched byte-by-byte, and positions are byte offsets,
+		// but the trivia limits and detection limits are treated as sets of whole characters, so a multi-byte character in them only ever matches that exact sequence.
+		bool IsUTF8;
+
+		// The tokens this configuration was made from. The multi-char tokens point into their data, and the events give them back, so they need to last as long as the configuration does.
+		ABParserToken<T, U>* Tokens;
+		uint32_t NumberOfTokens;
+
+		// Whether "Tokens" should be deleted along with the configuration.
+		bool OwnsTokens;
 
 		std::unordered_map<std::basic_string<U>, TokenLimit<T>*> TokenLimits;
 		std::unordered_map<std::basic_string<U>, TriviaLimit<T>*> TriviaLimits;
 
+		// Whether any of the tokens have limit rules, which means the limits can change without the events doing anything.
+		bool HasLimitRules;
+
 		ABParserConfiguration() {
 			SingleCharTokens = nullptr;
 			NumberOfSingleCharTokens = 0;
 
 			MultiCharTokens = nullptr;
 			NumberOfMultiCharTokens = 0;
+
+			RunTokens = nullptr;
+			NumberOfRunTokens = 0;
+
+			MultiCharContainment = nullptr;
+			TokenTrieThreshold = 1024;
+			MultiCharTrie = nullptr;
+			IsUTF8 = false;
+			HasLimitRules = false;
+
+			Tokens = nullptr;
+			NumberOfTokens = 0;
+			OwnsTokens = false;
+			referenceCount = 1;
 		}
 
-		ABParserConfiguration(ABParserToken<T, U>* tokens, uint16_t numberOfTokens) {
+		ABParserConfiguration(ABParserToken<T, U>* tokens, uint32_t numberOfTokens) {
+			MultiCharContainment = nullptr;
+			TokenTrieThreshold = 1024;
+			MultiCharTrie = nullptr;
+			IsUTF8 = false;
+			HasLimitRules = false;
+
+			OwnsTokens = false;
+			referenceCount = 1;
 			Init(tokens, numberOfTokens);
 		}
 		
-		void Init(ABParserToken<T, U>* tokens, uint16_t numberOfTokens) {
+		void Init(ABParserToken<T, U>* tokens, uint32_t numberOfTokens) {
+			Init(tokens, numberOfTokens, nullptr, nullptr);
+		}
+
+		// SEE ABSOFTWARE DOCS:
+		// These make a new configuration from this one, with a token added or taken away. This one is left exactly as it was, so any parsers in the middle of using it can carry on,
+		// and the new one gets swapped in for whatever starts next (see "ABParserConfigurationSource"). The tokens are all copied, but the ones that are carried over
+		// keep their place in the trie, so they don't all need sorting again. The trivia limits are shared with this one.
+
+		// Adds a copy of "token" on the end, so it has the index "NumberOfTokens".
+		ABParserConfiguration<T, U>* WithTokenAdded(const ABParserToken<T, U>& token) {
+			ABParserToken<T, U>* tokens = new ABParserToken<T, U>[(size_t)NumberOfTokens + 1];
+			std::vector<uint32_t> previousIdx((size_t)NumberOfTokens + 1);
+
+			for (uint32_t i = 0; i < NumberOfTokens; i++) {
+				tokens[i].CopyFrom(Tokens[i]);
+				previousIdx[i] = i;
+			}
+
+			tokens[NumberOfTokens].CopyFrom(token);
+			previousIdx[NumberOfTokens] = UINT32_MAX;
+
+			return MakeNextVersion(tokens, NumberOfTokens + 1, previousIdx);
+		}
+
+		// Takes away the token with the index "mixedIdx" - all of the ones after it move down by one.
+		ABParserConfiguration<T, U>* WithTokenRemoved(uint32_t mixedIdx) {
+			if (mixedIdx >= NumberOfTokens)
+				throw "There isn't a token with that index to remove.";
+
+			ABParserToken<T, U>* tokens = new ABParserToken<T, U>[(size_t)NumberOfTokens - 1];
+			std::vector<uint32_t> previousIdx((size_t)NumberOfTokens - 1);
+
+			for (uint32_t i = 0, j = 0; i < NumberOfTokens; i++) {
+				if (i == mixedIdx) continue;
+
+				tokens[j].CopyFrom(Tokens[i]);
+				previousIdx[j++] = i;
+			}
+
+			return MakeNextVersion(tokens, NumberOfTokens - 1, previousIdx);
+		}
+
+		// Adds a trivia limit, and points any limit rules that use it at it. This is still setting the configuration up, so it can't happen once it's shared (see "IsShared").
+		void AddTriviaLimit(const std::basic_string<U>& name, TriviaLimit<T>* limit) {
+			if (IsShared())
+				throw "Trivia limits can't be added to a configuration that's already being used by parsers.";
+
+			TriviaLimits[name] = limit;
+			ResolveLimitRules();
+		}
+
+		// Works out which limits the tokens' limit rules are talking about. This happens when the configuration is made, and whenever a trivia limit is added through "AddTriviaLimit",
+		// but anything that changes "TriviaLimits" directly needs to call this itself afterwards. Rules for limits that don't exist are ignored.
+		void ResolveLimitRules() {
+			HasLimitRules = false;
+
+			for (uint32_t i = 0; i < NumberOfSingleCharTokens; i++)
+				ResolveLimitRules(SingleCharTokens[i]);
+
+			for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++)
+				ResolveLimitRules(MultiCharTokens[i]);
+
+			for (uint32_t i = 0; i < NumberOfRunTokens; i++)
+				ResolveLimitRules(RunTokens[i]);
+		}
+
+		~ABParserConfiguration() {
+			if (SingleCharTokens != nullptr) {
+				for (uint32_t i = 0; i < NumberOfSingleCharTokens; i++) {
+					delete SingleCharTokens[i]->LimitRules;
+					delete SingleCharTokens[i];
+				}
+
+				delete[] SingleCharTokens;
+			}
+
+			if (MultiCharTokens != nullptr) {
+				for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++) {
+					delete MultiCharTokens[i]->LimitRules;
+					delete MultiCharTokens[i];
+				}
+
+				delete[] MultiCharTokens;
+			}
+
+			if (RunTokens != nullptr) {
+				for (uint32_t i = 0; i < NumberOfRunTokens; i++) {
+					delete RunTokens[i]->LimitRules;
+					delete RunTokens[i];
+				}
+
+				delete[] RunTokens;
+			}
+
+			for (auto& item : TokenLimits)
+				delete item.second;
+
+			delete[] MultiCharContainment;
+			delete MultiCharTrie;
+
+			if (OwnsTokens)
+				delete[] Tokens;
+		}
+
+		// SEE ABSOFTWARE DOCS:
+		// Once a configuration has been set up, nothing changes it, so any number of parsers, on any number of threads, can share it. Every parser holds a reference to its configuration,
+		// and it only gets deleted when the last reference is given up. Whoever created it holds the first reference, and should give that up with "Release" instead of deleting it
+		// (a configuration that isn't on the heap just never gets released, and has to outlive its parsers).
+		void AddReference() {
+			referenceCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Release() {
+			if (referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete this;
+		}
+
+		// Whether anything other than whoever created this (like a parser) holds a reference to it - once it does, it's too late to set anything else up on it.
+		bool IsShared() const {
+			return referenceCount.load(std::memory_order_acquire) > 1;
+		}
+
+		// Whether the contents of "inner" can be found "offset" characters into "outer".
+		bool MultiCharTokenContains(MultiCharToken<T>* outer, MultiCharToken<T>* inner, uint32_t offset) {
+			if (offset >= outer->TokenLength) return false;
+
+			if (!MultiCharContainment)
+				return inner->TokenLength <= outer->TokenLength - offset && ContentsMatch(outer->TokenContents + offset, inner->TokenContents, inner->TokenLength, outer->IgnoreCase || inner->IgnoreCase);
+
+			size_t bit = outer->ContainmentStart + (size_t)inner->Index * outer->TokenLength + offset;
+			return (MultiCharContainment[bit >> 6] >> (bit & 63)) & 1;
+		}
+	private:
+		std::atomic<uint32_t> referenceCount;
+
+		// "previous" is the configuration this is a new version of (if it is one), and "previousIdx" is what index each of the tokens had in it (or "UINT32_MAX" for new ones).
+		void Init(ABParserToken<T, U>* tokens, uint32_t numberOfTokens, ABParserConfiguration<T, U>* previous, const std::vector<uint32_t>* previousIdx) {
+			Tokens = tokens;
+			NumberOfTokens = numberOfTokens;
+
 			// Initialize the arrays the results will go into - we try to set them to the maximum potentional size it could be.
 			SingleCharTokens = new SingleCharToken<T>*[numberOfTokens];
 			NumberOfSingleCharTokens = 0;
@@ -223,73 +614,240 @@ namespace abparser {
 			MultiCharTokens = new MultiCharToken<T>*[numberOfTokens];
 			NumberOfMultiCharTokens = 0;
 
+			RunTokens = new RunToken<T>*[numberOfTokens];
+			NumberOfRunTokens = 0;
+
 			TokenLimits.reserve(numberOfTokens);
 
-			// One character big tokens are organized as "singleCharTokens" and multiple character-long tokens are "multiCharTokens".
-			for (int i = 0; i < numberOfTokens; i++) {
+			// One character big tokens are organized as "singleCharTokens" and multiple character-long tokens are "multiCharTokens" (unless they're run tokens).
+			for (uint32_t i = 0; i < numberOfTokens; i++) {
 				_ABP_DEBUG_OUT("Processing token %d", i);
 
 				ABParserToken<T, U>* CurrentEventToken = &(tokens[i]);
 
-				if (CurrentEventToken->DataLength == 1) {
+				if (CurrentEventToken->RunRanges) {
+					RunToken<T>* runToken = RunTokens[NumberOfRunTokens++] = new RunToken<T>();
+					runToken->IgnoreCase = CurrentEventToken->IgnoreCase;
+					runToken->MixedIdx = i;
+					runToken->Ranges = CurrentEventToken->RunRanges;
+					runToken->NumberOfRanges = CurrentEventToken->NumberOfRunRanges;
+					runToken->MinLength = CurrentEventToken->MinRunLength;
+					runToken->MaxLength = CurrentEventToken->MaxRunLength;
+
+					if (CurrentEventToken->Limits != nullptr)
+						ProcessTokenLimits(CurrentEventToken->Limits, CurrentEventToken->LimitsLength, runToken, false);
+					runToken->AddStartsTo(RunStarts);
+					runToken->AddStartsTo(TokenStarts);
+				}
+				else if (CurrentEventToken->DataLength == 1) {
 					SingleCharTokens[NumberOfSingleCharTokens] = new SingleCharToken<T>();
+					SingleCharTokens[NumberOfSingleCharTokens]->IgnoreCase = CurrentEventToken->IgnoreCase;
 					if (CurrentEventToken->Limits != nullptr)
-						ProcessTokenLimits(CurrentEventToken->Limits, CurrentEventToken->LimitsLength, SingleCharTokens[NumberOfSingleCharTokens], true, numberOfTokens);
+						ProcessTokenLimits(CurrentEventToken->Limits, CurrentEventToken->LimitsLength, SingleCharTokens[NumberOfSingleCharTokens], true);
+					SingleCharStarts.Add(CurrentEventToken->Data[0], CurrentEventToken->IgnoreCase);
+					TokenStarts.Add(CurrentEventToken->Data[0], CurrentEventToken->IgnoreCase);
 					SingleCharTokens[NumberOfSingleCharTokens]->MixedIdx = i;
 					SingleCharTokens[NumberOfSingleCharTokens++]->TokenChar = CurrentEventToken->Data[0];
 				}
 				else {
 					MultiCharTokens[NumberOfMultiCharTokens] = new MultiCharToken<T>();
+					MultiCharTokens[NumberOfMultiCharTokens]->IgnoreCase = CurrentEventToken->IgnoreCase;
 					if (CurrentEventToken->Limits != nullptr)
-						ProcessTokenLimits(CurrentEventToken->Limits, CurrentEventToken->LimitsLength, MultiCharTokens[NumberOfMultiCharTokens], false, numberOfTokens);
+						ProcessTokenLimits(CurrentEventToken->Limits, CurrentEventToken->LimitsLength, MultiCharTokens[NumberOfMultiCharTokens], false);
+					MultiCharStarts.Add(CurrentEventToken->Data[0], CurrentEventToken->IgnoreCase);
+					TokenStarts.Add(CurrentEventToken->Data[0], CurrentEventToken->IgnoreCase);
 					MultiCharTokens[NumberOfMultiCharTokens]->MixedIdx = i;
 					MultiCharTokens[NumberOfMultiCharTokens]->TokenContents = CurrentEventToken->Data;
 					MultiCharTokens[NumberOfMultiCharTokens]->DetectionLimit = CurrentEventToken->DetectionLimit;
 					MultiCharTokens[NumberOfMultiCharTokens]->DetectionLimitSize = CurrentEventToken->DetectionLimitSize;
+					MultiCharTokens[NumberOfMultiCharTokens]->Index = NumberOfMultiCharTokens;
 					MultiCharTokens[NumberOfMultiCharTokens++]->TokenLength = CurrentEventToken->DataLength;
 				}
 			}
+
+			// When this is a new version of another configuration, the multi-char tokens that were in that one too are matched up with what they've become here.
+			std::vector<MultiCharToken<T>*> replacements;
+			if (previous) {
+				std::vector<MultiCharToken<T>*> previousByMixedIdx(previous->NumberOfTokens);
+				for (uint32_t i = 0; i < previous->NumberOfMultiCharTokens; i++)
+					previousByMixedIdx[previous->MultiCharTokens[i]->MixedIdx] = previous->MultiCharTokens[i];
+
+				replacements.resize(previous->NumberOfMultiCharTokens);
+
+				for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++) {
+					uint32_t mixedIdx = (*previousIdx)[MultiCharTokens[i]->MixedIdx];
+					if (mixedIdx != UINT32_MAX && previousByMixedIdx[mixedIdx])
+						replacements[previousByMixedIdx[mixedIdx]->Index] = MultiCharTokens[i];
+				}
+			}
+
+			// (Working out which tokens are inside of which is no slower than copying it across would be, so that's just done again)
+			bool useTrie = NumberOfMultiCharTokens >= TokenTrieThreshold;
+			if (!useTrie) PrepareMultiCharContainment();
+			else if (previous && previous->MultiCharTrie) MultiCharTrie = new ABParserTokenTrie<T>(*previous->MultiCharTrie, replacements, MultiCharTokens, NumberOfMultiCharTokens);
+			else MultiCharTrie = new ABParserTokenTrie<T>(MultiCharTokens, NumberOfMultiCharTokens);
+
+			// Now that we know exactly which tokens are in each limit, we can shrink them down.
+			for (auto& item : TokenLimits) {
+				TokenLimit<T>* previousLimit = previous ? FindLimit(previous->TokenLimits, &item.first) : nullptr;
+				item.second->Finalize(useTrie, previousLimit ? previousLimit->MultiCharTrie : nullptr, &replacements);
+			}
+
+			ResolveLimitRules();
 		}
 
-		~ABParserConfiguration() {
-			if (SingleCharTokens != nullptr) {
-				for (int i = 0; i < NumberOfSingleCharTokens; i++)
-					delete SingleCharTokens[i];
+		ABParserConfiguration<T, U>* MakeNextVersion(ABParserToken<T, U>* tokens, uint32_t numberOfTokens, const std::vector<uint32_t>& previousIdx) {
+			ABParserConfiguration<T, U>* result = new ABParserConfiguration<T, U>();
+			result->TokenTrieThreshold = TokenTrieThreshold;
+			result->IsUTF8 = IsUTF8;
+			result->OwnsTokens = true;
+			result->TriviaLimits = TriviaLimits;
 
-				delete[] SingleCharTokens;
+			result->Init(tokens, numberOfTokens, this, &previousIdx);
+			return result;
+		}
+
+		void PrepareMultiCharContainment() {
+			delete[] MultiCharContainment;
+
+			size_t totalBits = 0;
+			for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++) {
+				MultiCharTokens[i]->ContainmentStart = totalBits;
+				totalBits += (size_t)NumberOfMultiCharTokens * MultiCharTokens[i]->TokenLength;
 			}
 
-			if (MultiCharTokens != nullptr) {
-				for (int i = 0; i < NumberOfMultiCharTokens; i++)
-					delete MultiCharTokens[i];
+			size_t numberOfWords = (totalBits + 63) / 64;
+			MultiCharContainment = new uint64_t[numberOfWords]();
 
-				delete[] MultiCharTokens;
+			for (uint32_t i = 0; i < NumberOfMultiCharTokens; i++) {
+				MultiCharToken<T>* outer = MultiCharTokens[i];
+
+				for (uint32_t j = 0; j < NumberOfMultiCharTokens; j++) {
+					MultiCharToken<T>* inner = MultiCharTokens[j];
+					if (inner->TokenLength > outer->TokenLength) continue;
+
+					// If either of them ignores case, the same text could match both as long as they're the same once folded.
+					bool ignoreCase = outer->IgnoreCase || inner->IgnoreCase;
+
+					for (uint32_t offset = 0; offset + inner->TokenLength <= outer->TokenLength; offset++)
+						if (ContentsMatch(outer->TokenContents + offset, inner->TokenContents, inner->TokenLength, ignoreCase)) {
+							size_t bit = outer->ContainmentStart + (size_t)j * outer->TokenLength + offset;
+							MultiCharContainment[bit >> 6] |= (uint64_t)1 << (bit & 63);
+						}
+				}
 			}
 		}
-	private:
-		void ProcessTokenLimits(const std::basic_string<U>** unorganizedLimits, uint16_t numberOfUnorganizedLimits, ABParserInternalToken<T>* token, bool isSingleChar, uint16_t maximumAmountOfTokens) {
+
+		static bool ContentsMatch(T* first, T* second, uint32_t length, bool ignoreCase) {
+			for (uint32_t i = 0; i < length; i++)
+				if (!CharactersMatch(first[i], second[i], ignoreCase))
+					return false;
+
+			return true;
+		}
+
+		void ResolveLimitRules(ABParserInternalToken<T>* token) {
+			ABParserToken<T, U>& source = Tokens[token->MixedIdx];
+			if (!source.HasLimitRules()) return;
+
+			if (!token->LimitRules) token->LimitRules = new ABParserLimitRules<T>();
+			token->LimitRules->EntersTokenLimit = FindLimit(TokenLimits, source.EntersTokenLimit);
+			token->LimitRules->ExitsTokenLimit = FindLimit(TokenLimits, source.ExitsTokenLimit);
+			token->LimitRules->EntersTriviaLimit = FindLimit(TriviaLimits, source.EntersTriviaLimit);
+			token->LimitRules->ExitsTriviaLimit = FindLimit(TriviaLimits, source.ExitsTriviaLimit);
+
+			HasLimitRules = true;
+		}
+
+		template<typename L>
+		static L* FindLimit(std::unordered_map<std::basic_string<U>, L*>& limits, const std::basic_string<U>* name) {
+			if (!name) return nullptr;
+
+			auto item = limits.find(*name);
+			return item == limits.end() ? nullptr : item->second;
+		}
+
+		void ProcessTokenLimits(const std::basic_string<U>** unorganizedLimits, uint16_t numberOfUnorganizedLimits, ABParserInternalToken<T>* token, bool isSingleChar) {
 
 			for (uint16_t i = 0; i < numberOfUnorganizedLimits; i++) {
 
 				auto item = TokenLimits.find(*(unorganizedLimits[i]));
 
 				// If there isn't already an organized limit for this, add one.
-				if (item == TokenLimits.end()) {
-					TokenLimit<T>* limit = new TokenLimit<T>(maximumAmountOfTokens);
+				if (item == TokenLimits.end())
+					item = TokenLimits.emplace(*(unorganizedLimits[i]), new TokenLimit<T>()).first;
+
+				item->second->AddToken(token, isSingleChar);
+			}
+		}
+	};
+
+	// SEE ABSOFTWARE DOCS:
+	// Holds the latest version of a configuration that has tokens added and taken away while it's in use. Each change makes a whole new version (see "ABParserConfiguration::WithTokenAdded")
+	// and swaps it in, and the old one is just released - so a parse that's already going carries on with the version it started with, which is only deleted once nothing's using it.
+	// Parsers given this as their "ConfigurationSource" move onto the latest version whenever they're given new text.
+	template<typename T, typename U = char>
+	class ABParserConfigurationSource {
+	public:
+		// This takes over the reference to "configuration" that whoever made it had.
+		ABParserConfigurationSource(ABParserConfiguration<T, U>* configuration) {
+			current = configuration;
+			version = 0;
+		}
 
-					if (isSingleChar)
-						limit->SingleCharTokens[limit->NumberOfSingleCharTokens++] = (SingleCharToken<T>*)token;
-					else
-						limit->MultiCharTokens[limit->NumberOfMultiCharTokens++] = (MultiCharToken<T>*)token;
+		~ABParserConfigurationSource() {
+			current->Release();
+		}
 
-					TokenLimits.emplace(std::move(*(unorganizedLimits[i])), limit);
-				}
+		// Gives a reference to the latest version, which needs giving up with "Release" once it's finished with.
+		ABParserConfiguration<T, U>* Acquire() {
+			std::lock_guard<std::mutex> lock(currentLock);
+
+			current->AddReference();
+			return current;
+		}
+
+		// Goes up every time a new version is swapped in. This doesn't lock anything, so it's cheap enough to check before every parse.
+		uint64_t GetVersion() {
+			return version.load(std::memory_order_acquire);
+		}
+
+		// Changes from different threads take it in turns. The new version is made without holding up anything that's using the current one - they only wait for the swap itself.
+		void AddToken(const ABParserToken<T, U>& token) {
+			std::lock_guard<std::mutex> lock(updateLock);
+			SwapIn(current->WithTokenAdded(token));
+		}
+
+		void RemoveToken(uint32_t mixedIdx) {
+			std::lock_guard<std::mutex> lock(updateLock);
+			SwapIn(current->WithTokenRemoved(mixedIdx));
+		}
+
+		// Swaps in a version that was made some other way, taking over the reference to it that whoever made it had.
+		void Publish(ABParserConfiguration<T, U>* configuration) {
+			std::lock_guard<std::mutex> lock(updateLock);
+			SwapIn(configuration);
+		}
+
+	private:
+		// Only changed while both of the locks are held, so holding either one is enough to read it.
+		ABParserConfiguration<T, U>* current;
+		std::atomic<uint64_t> version;
 
-				else if (isSingleChar)
-					item->second->SingleCharTokens[item->second->NumberOfSingleCharTokens++] = (SingleCharToken<T>*)token;
-				else
-					item->second->MultiCharTokens[item->second->NumberOfMultiCharTokens++] = (MultiCharToken<T>*)token;
+		std::mutex currentLock;
+		std::mutex updateLock;
+
+		void SwapIn(ABParserConfiguration<T, U>* configuration) {
+			ABParserConfiguration<T, U>* old;
+
+			{
+				std::lock_guard<std::mutex> lock(currentLock);
+				old = current;
+				current = configuration;
+				version.fetch_add(1, std::memory_order_release);
 			}
+
+			old->Release();
 		}
 	};
 }
@@ -0,0 +1,116 @@
+#ifndef _ABPARSER_INCLUDE_COROUTINE_H
+#define _ABPARSER_INCLUDE_COROUTINE_H
+#include "ABParserBase.h"
+
+// This is only available when compiling as C++20 (or later), with coroutine support.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define _ABP_HAS_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace abparser {
+
+	// One result from "ContinueExecution", along with everything that goes with it.
+	template<typename T>
+	class ABParserEvent {
+	public:
+		ABParserResult Result = ABParserResult::None;
+
+		// Not set for "OnFirstUnlimitedCharacterProcessed" or "StopAndFinalOnTokenProcessed".
+		ABParserInternalToken<T>* Token = nullptr;
+		uint32_t TokenStart = 0;
+		uint32_t TokenLengthInText = 0;
+
+		// This points straight into the parser, so it's only valid until the next event is asked for.
+		T* Trivia = nullptr;
+		uint32_t TriviaLength = 0;
+
+		// Only set for "OnFirstUnlimitedCharacterProcessed" and "Yielded".
+		uint32_t Position = 0;
+	};
+
+	// The events of a parse, as they come. The parser only moves on when the next event is asked for, so a consumer that can't take any more right now (e.g. its downstream queue is full)
+	// can just stop asking, and the parse will stay suspended for as long as it needs, without holding up a thread. Limits can be entered and exited between events, like normal.
+	// If a stream is dropped part-way through, call "ResetParseState" on the parser before using it again.
+	template<typename T, typename U = char>
+	class ABParserEventStream {
+	public:
+		class promise_type {
+		public:
+			ABParserEvent<T> Current;
+			std::exception_ptr Exception;
+
+			ABParserEventStream get_return_object() { return ABParserEventStream(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+
+			std::suspend_always yield_value(const ABParserEvent<T>& event) {
+				Current = event;
+				return {};
+			}
+
+			void return_void() {}
+			void unhandled_exception() { Exception = std::current_exception(); }
+		};
+
+		ABParserEventStream(const ABParserEventStream&) = delete;
+		ABParserEventStream(ABParserEventStream&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+		~ABParserEventStream() {
+			if (handle) handle.destroy();
+		}
+
+		// Runs the parse up to its next event - false once there aren't any more.
+		bool Next() {
+			handle.resume();
+
+			if (handle.promise().Exception)
+				std::rethrow_exception(handle.promise().Exception);
+
+			return !handle.done();
+		}
+
+		const ABParserEvent<T>& Current() const { return handle.promise().Current; }
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+
+		explicit ABParserEventStream(std::coroutine_handle<promise_type> h) : handle(h) {}
+	};
+
+	// Goes through the whole parse, yielding every result "ContinueExecution" gives (apart from "None"), finishing on "StopAndFinalOnTokenProcessed". That includes "Yielded", so a consumer
+	// can use the parser's budget to get control back regularly even when there aren't any tokens.
+	template<typename T, typename U>
+	ABParserEventStream<T, U> ParseEvents(ABParserBase<T, U>* parser) {
+		ABParserResult result;
+
+		do {
+			result = parser->ContinueExecution();
+			if (result == ABParserResult::None) continue;
+
+			ABParserEvent<T> event;
+			event.Result = result;
+
+			if (result == ABParserResult::OnFirstUnlimitedCharacterProcessed || result == ABParserResult::Yielded)
+				event.Position = parser->InternalPosition;
+			else {
+				if (result != ABParserResult::StopAndFinalOnTokenProcessed) {
+					event.Token = parser->CurrentEventToken;
+					event.TokenStart = parser->CurrentEventTokenStart;
+					event.TokenLengthInText = parser->CurrentEventTokenLengthInText;
+				}
+
+				event.Trivia = parser->CurrentTrivia;
+				event.TriviaLength = parser->CurrentTriviaLength;
+			}
+
+			co_yield event;
+		} while (result != ABParserResult::StopAndFinalOnTokenProcessed);
+	}
+}
+#endif
+#endif
+#endif
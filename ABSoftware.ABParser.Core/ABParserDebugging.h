@@ -2,10 +2,14 @@
 #ifndef _ABPARSER_INCLUDE_DEBUGGING_H
 #define _ABPARSER_INCLUDE_DEBUGGING_H
 #include <string>
+#include <stdint.h>
 
 // Enable to show all of the logging, in order to help identify where problems are occuring.
 //#define _ABP_IS_DEBUG
 
+// Enable to keep count of what the parser is doing (see "ABParserStatistics" below), without any of the logging. When this is off, none of the counting code is compiled in.
+//#define _ABP_COLLECT_STATS
+
 #ifdef _ABP_IS_DEBUG
 
 #include <stdio.h>
@@ -23,4 +27,66 @@ void abpDebugLog(std::string str, ...) {
 #else
 #define _ABP_DEBUG_OUT
 #endif
-#endif
\ No newline at end of file
+
+namespace abparser {
+
+	// The counters collected when "_ABP_COLLECT_STATS" is enabled. This is always available (and is just left as zeros otherwise), so that its layout doesn't change depending on how the core was compiled.
+	// SEE ABSOFTWARE DOCS: This is passed straight across to the managed side, so the order and size of these fields must match "ABParserStatistics" there.
+	struct ABParserStatistics {
+		uint64_t CharactersProcessed;
+
+		uint64_t FutureTokensCreated;
+		uint64_t FutureTokensDisabled;
+
+		uint64_t VerifyTokensStarted;
+		uint64_t VerifyTokensStopped;
+		uint64_t VerifyTokensFinalized;
+
+		uint64_t TriviaBytesCopied;
+
+		uint64_t TokenLimitsEntered;
+		uint64_t TokenLimitsExited;
+		uint64_t TriviaLimitsEntered;
+		uint64_t TriviaLimitsExited;
+
+		// The time spent in each phase of "ContinueExecution", in nanoseconds.
+		uint64_t UpdateFutureTokensTime;
+		uint64_t AddFutureTokensTime;
+		uint64_t ProcessFinishedTokensTime;
+		uint64_t FinalizeVerifyTokensTime;
+	};
+}
+
+#ifdef _ABP_COLLECT_STATS
+
+#include <chrono>
+
+namespace abparser {
+
+	// Adds the time between its creation and destruction onto a counter.
+	class ABParserPhaseTimer {
+	public:
+		uint64_t* Counter;
+		std::chrono::steady_clock::time_point Start;
+
+		ABParserPhaseTimer(uint64_t* counter) {
+			Counter = counter;
+			Start = std::chrono::steady_clock::now();
+		}
+
+		~ABParserPhaseTimer() {
+			*Counter += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+		}
+	};
+}
+
+#define _ABP_STAT_ADD(name, amount) Statistics.name += (amount)
+#define _ABP_STAT_INC(name) Statistics.name++
+#define _ABP_STAT_TIME(name) ABParserPhaseTimer _abpPhaseTimer(&Statistics.name)
+
+#else
+#define _ABP_STAT_ADD(name, amount)
+#define _ABP_STAT_INC(name)
+#define _ABP_STAT_TIME(name)
+#endif
+#endif
@@ -4,6 +4,15 @@
 #include <stdint.h>
 #include <memory>
 #include <wchar.h>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+// SSE2 is always there on x64, so the first characters of tokens can be searched for 16 bytes at a time. Anywhere else, the search is done a character at a time instead.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _ABP_HAS_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace abparser {
 	enum class ABParserResult : int {
@@ -11,7 +20,45 @@ namespace abparser {
 		StopAndFinalOnTokenProcessed,
 		FirstBeforeTokenProcessed,
 		OnThenBeforeTokenProcessed,
-		OnFirstUnlimitedCharacterProcessed
+		OnFirstUnlimitedCharacterProcessed,
+
+		// The parse stopped part-way through because it used up its budget (see "ABParserBase::CharacterBudget") - nothing's happened, it just needs continuing again.
+		Yielded
+	};
+
+	// What happens to the text of a token the parser isn't subscribed to.
+	enum class ABParserUnsubscribedTokens : int {
+		// It's left in the trivia around it, as if it wasn't a token at all.
+		AsTrivia,
+
+		// It's taken out, so it isn't in any trivia.
+		Skip
+	};
+
+	// Which events the trivia given to "ABParser::OnTriviaChunk" belongs to.
+	enum class ABParserTriviaChunkKind : int {
+		// Only the leading of the first token, as nothing came before it.
+		Leading,
+
+		// The trailing of one token, and the leading of the one after it.
+		Between,
+
+		// Only the trailing of the last token (and what "OnEnd" is given).
+		Trailing
+	};
+
+	template<typename T> class TokenLimit;
+	template<typename T> class TriviaLimit;
+
+	// The limits a token enters or exits by itself whenever it's found (as if "BeforeTokenProcessed" had done it). An exit only happens if that limit is the current one,
+	// and takes priority over entering - so a token that both enters and exits the same limit (like a quote) toggles in and out of it.
+	template<typename T>
+	class ABParserLimitRules {
+	public:
+		TokenLimit<T>* EntersTokenLimit = nullptr;
+		TokenLimit<T>* ExitsTokenLimit = nullptr;
+		TriviaLimit<T>* EntersTriviaLimit = nullptr;
+		TriviaLimit<T>* ExitsTriviaLimit = nullptr;
 	};
 
 	template<typename T>
@@ -19,9 +66,17 @@ namespace abparser {
 	public:
 
 		// When we created an instance of ABParser, the single-char tokens and multi-char tokens were mixed together, this is at what index this token would've been mixed in.
-		uint16_t MixedIdx = 0;
+		uint32_t MixedIdx = 0;
+
+		// Whether the text's characters are case-folded before they're compared to this token's (see "FoldCase").
+		bool IgnoreCase = false;
+
+		// Only set if the token has any limit rules (see "ABParserToken::SetEntersTokenLimit"). This belongs to the configuration.
+		ABParserLimitRules<T>* LimitRules = nullptr;
+
 		virtual uint16_t GetLength() { return 0; }
 		virtual bool IsSingleChar() { return false; }
+		virtual bool IsRun() { return false; }
 	};
 
 	template<typename T>
@@ -42,10 +97,404 @@ namespace abparser {
 		T* TokenContents = nullptr;
 		uint32_t TokenLength = 0;
 
+		// Where this token is in the configuration's multi-char tokens, and where its row starts in the configuration's "MultiCharContainment" (if there is one).
+		uint32_t Index = 0;
+		size_t ContainmentStart = 0;
+
 		uint16_t GetLength() { return TokenLength; }
 		bool IsSingleChar() { return false; }
 	};
 
+	// Simple case folding - every capital letter gives its small letter, and anything else is left as it is. For 8-bit characters (including UTF-8) this is only ASCII, as anything
+	// else would be part of a multi-byte character. Wider characters also fold Latin-1, Greek and Cyrillic capitals.
+	template<typename T>
+	T FoldCase(T ch) {
+		uint32_t code = (uint32_t)(typename std::make_unsigned<T>::type)ch;
+
+		if (code >= 'A' && code <= 'Z') return (T)(code + 0x20);
+		if (sizeof(T) == 1 || code < 0xC0) return ch;
+
+		if (code <= 0xDE && code != 0xD7) return (T)(code + 0x20);
+		if (code >= 0x391 && code <= 0x3A9 && code != 0x3A2) return (T)(code + 0x20);
+		if (code >= 0x410 && code <= 0x42F) return (T)(code + 0x20);
+		if (code >= 0x400 && code <= 0x40F) return (T)(code + 0x50);
+		return ch;
+	}
+
+	// The capital letter that folds to "ch" (if there is one), for when every way a character could appear needs to be known up-front.
+	template<typename T>
+	T UnfoldCase(T ch) {
+		uint32_t code = (uint32_t)(typename std::make_unsigned<T>::type)ch;
+
+		if (code >= 'a' && code <= 'z') return (T)(code - 0x20);
+		if (sizeof(T) == 1 || code < 0xE0) return ch;
+
+		if (code <= 0xFE && code != 0xF7) return (T)(code - 0x20);
+		if (code >= 0x3B1 && code <= 0x3C9 && code != 0x3C2) return (T)(code - 0x20);
+		if (code >= 0x430 && code <= 0x44F) return (T)(code - 0x20);
+		if (code >= 0x450 && code <= 0x45F) return (T)(code - 0x50);
+		return ch;
+	}
+
+	template<typename T>
+	inline bool CharactersMatch(T tokenChar, T textChar, bool ignoreCase) {
+		return tokenChar == textChar || (ignoreCase && FoldCase(tokenChar) == FoldCase(textChar));
+	}
+
+	// Any run of characters from a set of ranges, like "[0-9]+" - see "ABParserToken::SetRun".
+	template<typename T>
+	class RunToken : public ABParserInternalToken<T> {
+	public:
+		// Pairs of characters - the first and last character of each range (both included).
+		T* Ranges = nullptr;
+		uint16_t NumberOfRanges = 0;
+
+		uint32_t MinLength = 1;
+
+		// 0 if there isn't a maximum.
+		uint32_t MaxLength = 0;
+
+		bool IsRun() { return true; }
+
+		bool Contains(T ch) const {
+			if (InRanges(ch)) return true;
+			if (!this->IgnoreCase) return false;
+
+			T folded = FoldCase(ch);
+			return InRanges(folded) || InRanges(UnfoldCase(folded));
+		}
+
+		// How long the run starting at "pos" is (stopping once it's "MaxLength" long).
+		uint32_t LengthAt(const T* text, uint32_t pos, uint32_t length) const {
+			uint32_t end = MaxLength && length - pos > MaxLength ? pos + MaxLength : length;
+
+			uint32_t i = pos;
+			while (i < end && Contains(text[i])) i++;
+			return i - pos;
+		}
+
+		// Adds every character a run could start with to "starts" (a "FirstCharacterTable" or "FirstCharacterScanner"). Those only go by the lowest 8 bits of each character,
+		// so any range wider than that covers all of them already.
+		template<typename S>
+		void AddStartsTo(S& starts) const {
+			for (uint16_t i = 0; i < NumberOfRanges; i++) {
+				uint32_t first = Code(Ranges[i * 2]), last = Code(Ranges[i * 2 + 1]);
+				if (last > first + 255) last = first + 255;
+
+				for (uint32_t code = first; code <= last; code++)
+					starts.Add((T)code, this->IgnoreCase);
+			}
+		}
+
+	private:
+		static uint32_t Code(T ch) {
+			return (uint32_t)(typename std::make_unsigned<T>::type)ch;
+		}
+
+		bool InRanges(T ch) const {
+			uint32_t code = Code(ch);
+
+			for (uint16_t i = 0; i < NumberOfRanges; i++)
+				if (code >= Code(Ranges[i * 2]) && code <= Code(Ranges[i * 2 + 1]))
+					return true;
+
+			return false;
+		}
+	};
+
+	// A bitmap of what characters a set of tokens can start with, used to skip over characters that can't possibly start a token without looking at every token.
+	// Only the lowest 8 bits of the character are used, so for wider characters this can give false positives (but never false negatives), and a full check is still needed.
+	template<typename T>
+	class FirstCharacterTable {
+	public:
+		uint64_t Bits[4];
+
+		FirstCharacterTable() {
+			Clear();
+		}
+
+		void Clear() {
+			Bits[0] = Bits[1] = Bits[2] = Bits[3] = 0;
+		}
+
+		void Add(T ch) {
+			uint8_t idx = (uint8_t)ch;
+			Bits[idx >> 6] |= (uint64_t)1 << (idx & 63);
+		}
+
+		// Adds every case "ch" could be in, if the token it's from ignores case.
+		void Add(T ch, bool ignoreCase) {
+			Add(ch);
+			if (ignoreCase) {
+				Add(FoldCase(ch));
+				Add(UnfoldCase(FoldCase(ch)));
+			}
+		}
+
+		bool MayContain(T ch) const {
+			uint8_t idx = (uint8_t)ch;
+			return (Bits[idx >> 6] >> (idx & 63)) & 1;
+		}
+	};
+
+	// Finds the next place in a text that any of a set of tokens could start, so that stretches of text without any tokens in them can be skipped over all at once.
+	// When there are only a few different first characters, they're compared against a whole block of the text at a time (for 8-bit and 16-bit characters), otherwise it falls back to the table.
+	template<typename T>
+	class FirstCharacterScanner {
+	public:
+		FirstCharacterTable<T> Table;
+
+		static const uint8_t MaxVectorizedCharacters = 8;
+		T Characters[MaxVectorizedCharacters];
+		uint8_t NumberOfCharacters;
+		bool IsVectorized;
+
+		FirstCharacterScanner() {
+			Clear();
+		}
+
+		void Clear() {
+			Table.Clear();
+			NumberOfCharacters = 0;
+			IsVectorized = sizeof(T) <= 2;
+		}
+
+		void Add(T ch) {
+			Table.Add(ch);
+
+			for (uint8_t i = 0; i < NumberOfCharacters; i++)
+				if (Characters[i] == ch) return;
+
+			if (NumberOfCharacters == MaxVectorizedCharacters) IsVectorized = false;
+			else Characters[NumberOfCharacters++] = ch;
+		}
+
+		void Add(T ch, bool ignoreCase) {
+			Add(ch);
+			if (ignoreCase) {
+				Add(FoldCase(ch));
+				Add(UnfoldCase(FoldCase(ch)));
+			}
+		}
+
+		// Adds all of another scanner's characters, so this finds anywhere that either of them would.
+		void Add(const FirstCharacterScanner<T>& other) {
+			for (uint8_t i = 0; i < 4; i++)
+				Table.Bits[i] |= other.Table.Bits[i];
+
+			for (uint8_t i = 0; i < other.NumberOfCharacters; i++)
+				Add(other.Characters[i]);
+
+			if (!other.IsVectorized) IsVectorized = false;
+		}
+
+		// The first position from "pos" onwards that has one of the characters on it (or might, for wider characters), or "length" if there aren't any.
+		uint32_t FindNext(const T* text, uint32_t pos, uint32_t length) const {
+#ifdef _ABP_HAS_SSE2
+			if (IsVectorized) pos = FindNextVectorized(text, pos, length);
+#endif
+
+			while (pos < length && !Table.MayContain(text[pos])) pos++;
+			return pos;
+		}
+
+	private:
+#ifdef _ABP_HAS_SSE2
+		// Goes through whole blocks of the text, stopping at the first block with a match in it - the rest is left for the table.
+		uint32_t FindNextVectorized(const T* text, uint32_t pos, uint32_t length) const {
+			const uint32_t perBlock = 16 / sizeof(T);
+
+			__m128i characters[MaxVectorizedCharacters];
+			for (uint8_t i = 0; i < NumberOfCharacters; i++)
+				characters[i] = sizeof(T) == 1 ? _mm_set1_epi8((char)Characters[i]) : _mm_set1_epi16((short)Characters[i]);
+
+			for (; pos + perBlock <= length; pos += perBlock) {
+				__m128i block = _mm_loadu_si128((const __m128i*)(text + pos));
+				__m128i matches = _mm_setzero_si128();
+
+				for (uint8_t i = 0; i < NumberOfCharacters; i++)
+					matches = _mm_or_si128(matches, sizeof(T) == 1 ? _mm_cmpeq_epi8(block, characters[i]) : _mm_cmpeq_epi16(block, characters[i]));
+
+				if (_mm_movemask_epi8(matches)) break;
+			}
+
+			return pos;
+		}
+#endif
+	};
+
+	// Looks up multi-char tokens by their contents, so that finding the ones that start at a position doesn't mean checking every token one-by-one - which matters once there are lots of them.
+	// The nodes are stored in the order they'd be gone through breadth-first, with each node's children (sorted by character) all next to each other, so it's just a few flat arrays.
+	// It goes by the case-folded contents, so a token that doesn't ignore case gets checked properly once its end is reached.
+	template<typename T>
+	class ABParserTokenTrie {
+	public:
+		// Tokens with detection limits can have characters in the middle of them that get skipped over, so they can't be looked up by their contents - these still need checking one-by-one.
+		std::vector<MultiCharToken<T>*> UnindexedTokens;
+
+		ABParserTokenTrie(MultiCharToken<T>** tokens, uint32_t numberOfTokens) {
+			sortedTokens.reserve(numberOfTokens);
+
+			for (uint32_t i = 0; i < numberOfTokens; i++)
+				if (tokens[i]->DetectionLimitSize) UnindexedTokens.push_back(tokens[i]);
+				else sortedTokens.push_back(tokens[i]);
+
+			std::sort(sortedTokens.begin(), sortedTokens.end(), Precedes);
+			Build();
+		}
+
+		// Makes a trie for "tokens" out of one that was made for mostly the same tokens, so that they don't all need sorting again. "replacements" is what each of the earlier
+		// tokens (by their "Index") has become, or null if it's gone - anything in "tokens" that isn't one of those gets put into place by itself.
+		ABParserTokenTrie(const ABParserTokenTrie<T>& previous, const std::vector<MultiCharToken<T>*>& replacements, MultiCharToken<T>** tokens, uint32_t numberOfTokens) {
+			std::vector<bool> carried;
+			sortedTokens.reserve(numberOfTokens);
+
+			for (size_t i = 0; i < previous.UnindexedTokens.size(); i++)
+				Carry(replacements[previous.UnindexedTokens[i]->Index], UnindexedTokens, carried);
+
+			for (size_t i = 0; i < previous.sortedTokens.size(); i++)
+				Carry(replacements[previous.sortedTokens[i]->Index], sortedTokens, carried);
+
+			for (uint32_t i = 0; i < numberOfTokens; i++) {
+				MultiCharToken<T>* token = tokens[i];
+				if (token->Index < carried.size() && carried[token->Index]) continue;
+
+				if (token->DetectionLimitSize) UnindexedTokens.push_back(token);
+				else sortedTokens.insert(std::upper_bound(sortedTokens.begin(), sortedTokens.end(), token, Precedes), token);
+			}
+
+			Build();
+		}
+
+		// Adds every token that's in the text at "pos" onto "matches".
+		void FindMatches(const T* text, uint32_t pos, uint32_t length, std::vector<MultiCharToken<T>*>& matches) const {
+			uint32_t node = 0;
+
+			for (uint32_t depth = 0;; depth++) {
+				for (uint32_t i = nodes[node].FirstToken; i < nodes[node + 1].FirstToken; i++)
+					if (endingTokens[i]->IgnoreCase || ContentsAreExactly(endingTokens[i], text + pos))
+						matches.push_back(endingTokens[i]);
+
+				if (pos + depth >= length) return;
+
+				uint32_t edge = FindChild(node, Key(text[pos + depth]));
+				if (edge == UINT32_MAX) return;
+
+				node = edge + 1;
+			}
+		}
+
+	private:
+		// Node "n"'s children are the edges from its "FirstChild" up to the next node's, and edge "e" goes to node "e + 1". The tokens that end at each node are laid out the same way.
+		// There's one extra node on the end, so that the last real one knows where its edges and tokens finish.
+		class Node {
+		public:
+			uint32_t FirstChild;
+			uint32_t FirstToken;
+		};
+
+		std::vector<Node> nodes;
+		std::vector<T> childCharacters;
+		std::vector<MultiCharToken<T>*> endingTokens;
+
+		// Kept so that the next trie made from this one can start from them (see the second constructor).
+		std::vector<MultiCharToken<T>*> sortedTokens;
+
+		class Range {
+		public:
+			uint32_t Start;
+			uint32_t End;
+			uint32_t Depth;
+		};
+
+		static uint32_t Key(T ch) {
+			return (uint32_t)(typename std::make_unsigned<T>::type)FoldCase(ch);
+		}
+
+		// Once they're sorted, every node is just a range of them that all start the same way (with any that end at that node first).
+		static bool Precedes(MultiCharToken<T>* first, MultiCharToken<T>* second) {
+			uint32_t length = first->TokenLength < second->TokenLength ? first->TokenLength : second->TokenLength;
+
+			for (uint32_t i = 0; i < length; i++) {
+				uint32_t firstKey = Key(first->TokenContents[i]), secondKey = Key(second->TokenContents[i]);
+				if (firstKey != secondKey) return firstKey < secondKey;
+			}
+
+			if (first->TokenLength != second->TokenLength) return first->TokenLength < second->TokenLength;
+			return first->Index < second->Index;
+		}
+
+		static void Carry(MultiCharToken<T>* replacement, std::vector<MultiCharToken<T>*>& into, std::vector<bool>& carried) {
+			if (!replacement) return;
+
+			if (carried.size() <= replacement->Index) carried.resize((size_t)replacement->Index + 1);
+			carried[replacement->Index] = true;
+			into.push_back(replacement);
+		}
+
+		void Build() {
+			std::vector<MultiCharToken<T>*>& sorted = sortedTokens;
+			std::vector<Range> ranges;
+			ranges.push_back({ 0, (uint32_t)sorted.size(), 0 });
+
+			for (size_t n = 0; n < ranges.size(); n++) {
+				Range range = ranges[n];
+				nodes.push_back({ (uint32_t)childCharacters.size(), (uint32_t)endingTokens.size() });
+
+				uint32_t i = range.Start;
+				for (; i < range.End && sorted[i]->TokenLength == range.Depth; i++)
+					endingTokens.push_back(sorted[i]);
+
+				while (i < range.End) {
+					uint32_t key = Key(sorted[i]->TokenContents[range.Depth]);
+
+					uint32_t end = i + 1;
+					while (end < range.End && Key(sorted[end]->TokenContents[range.Depth]) == key) end++;
+
+					childCharacters.push_back(FoldCase(sorted[i]->TokenContents[range.Depth]));
+					ranges.push_back({ i, end, range.Depth + 1 });
+					i = end;
+				}
+			}
+
+			nodes.push_back({ (uint32_t)childCharacters.size(), (uint32_t)endingTokens.size() });
+		}
+
+		uint32_t FindChild(uint32_t node, uint32_t key) const {
+			uint32_t start = nodes[node].FirstChild, end = nodes[node + 1].FirstChild;
+
+			while (start < end) {
+				uint32_t middle = start + (end - start) / 2;
+				uint32_t middleKey = (uint32_t)(typename std::make_unsigned<T>::type)childCharacters[middle];
+
+				if (middleKey == key) return middle;
+				if (middleKey < key) start = middle + 1;
+				else end = middle;
+			}
+
+			return UINT32_MAX;
+		}
+
+		static bool ContentsAreExactly(MultiCharToken<T>* token, const T* text) {
+			for (uint32_t i = 0; i < token->TokenLength; i++)
+				if (token->TokenContents[i] != text[i]) return false;
+
+			return true;
+		}
+	};
+
+	template<typename T>
+	class ABParserVerifyToken;
+
+	// Points to one of the triggers in a verify token. Every future token keeps a chain of these for all of the verify tokens that are waiting on it, so that when it gets
+	// disabled or finished we can go straight to those verify tokens, instead of searching through every trigger of every verify token.
+	template<typename T>
+	class ABParserTriggerReference {
+	public:
+		ABParserVerifyToken<T>* Token = nullptr;
+		uint32_t Slot = 0;
+	};
+
 	template<typename T>
 	class ABParserFutureToken {
 	public:
@@ -59,6 +508,12 @@ namespace abparser {
 		bool IsBeingVerified;
 		bool EndOfArray;
 
+		// In UTF-8, when a multi-byte character matches the detection limit, the rest of its bytes need to be ignored too.
+		uint8_t CodeUnitsToIgnore;
+
+		// The first verify token trigger that's waiting on this token, the rest follow on from that trigger's "NextReferences".
+		ABParserTriggerReference<T> FirstReference;
+
 		ABParserFutureToken() {
 			Reset(nullptr);
 		}
@@ -71,7 +526,63 @@ namespace abparser {
 			IsBeingVerified = false;
 			LengthInText = 0;
 			NoOfCharactersMatched = 0;
+			CodeUnitsToIgnore = 0;
+			FirstReference = ABParserTriggerReference<T>();
+		}
+	};
+
+	// Where the rows of future tokens for each position come from. Each row is only as big as the number of tokens that actually started there (plus the end of it), rather than
+	// having room for every multi-char token at every position. Nothing gets freed on its own - once nothing's in progress, everything is given back in one go with "Rewind".
+	template<typename T>
+	class ABParserFutureTokenArena {
+	public:
+		static const uint32_t BlockSize = 4096;
+
+		ABParserFutureTokenArena() {
+			currentBlock = 0;
+			used = 0;
+		}
+
+		~ABParserFutureTokenArena() {
+			Clear();
 		}
+
+		ABParserFutureToken<T>* Allocate(uint32_t count) {
+			for (; currentBlock < blocks.size(); currentBlock++, used = 0)
+				if (blockSizes[currentBlock] - used >= count) {
+					used += count;
+					return blocks[currentBlock] + used - count;
+				}
+
+			uint32_t size = BlockSize;
+			if (count > size) size = count;
+
+			blocks.push_back(new ABParserFutureToken<T>[size]);
+			blockSizes.push_back(size);
+			used = count;
+			return blocks.back();
+		}
+
+		// Everything that's been allocated can be given out again (the blocks themselves are kept).
+		void Rewind() {
+			currentBlock = 0;
+			used = 0;
+		}
+
+		void Clear() {
+			for (size_t i = 0; i < blocks.size(); i++)
+				delete[] blocks[i];
+
+			blocks.clear();
+			blockSizes.clear();
+			Rewind();
+		}
+
+	private:
+		std::vector<ABParserFutureToken<T>*> blocks;
+		std::vector<uint32_t> blockSizes;
+		size_t currentBlock;
+		uint32_t used;
 	};
 
 	template<typename T>
@@ -83,15 +594,22 @@ namespace abparser {
 		ABParserFutureToken<T>** Triggers;
 		uint32_t* TriggerStarts;
 
+		// For each trigger, the next verify token trigger that's waiting on the same future token.
+		ABParserTriggerReference<T>* NextReferences;
+
 		// 0 if this token has been confirmed.
-		uint16_t TriggersLength;
+		uint32_t TriggersLength;
+
+		// How many of the triggers haven't been disabled yet.
+		uint32_t RemainingTriggers;
 
-		T* TrailingBuildUp;
-		uint32_t TrailingBuildUpLength;
+		// Verify tokens are numbered in the order they were started in, so that when a trigger finishes, we can tell which verify token it would've been found in first.
+		uint32_t Order;
+		bool IsStopped;
 
 		uint32_t Start;
 
-		ABParserVerifyToken(void* token, bool isSingleChar, uint32_t start, T* trailingBuildUp) {
+		ABParserVerifyToken(void* token, bool isSingleChar, uint32_t start) {
 			Token = token;
 			IsSingleChar = isSingleChar;
 
@@ -99,15 +617,18 @@ namespace abparser {
 
 			Triggers = nullptr;
 			TriggerStarts = nullptr;
+			NextReferences = nullptr;
 			TriggersLength = 0;
+			RemainingTriggers = 0;
 
-			TrailingBuildUp = trailingBuildUp;
-			TrailingBuildUpLength = 0;
+			Order = 0;
+			IsStopped = false;
 		}
 
 		~ABParserVerifyToken() {
 			delete[] Triggers;
 			delete[] TriggerStarts;
+			delete[] NextReferences;
 		}
 	};
 
@@ -121,5 +642,34 @@ namespace abparser {
 
 		return true;
 	}
+
+	// How many bytes the UTF-8 character starting with "lead" takes up. Stray continuation bytes and invalid lead bytes count as a character on their own, so broken text can't make us skip past anything.
+	inline uint8_t UTF8CharacterLength(uint8_t lead) {
+		if (lead < 0xC0) return 1;
+		if (lead < 0xE0) return 2;
+		if (lead < 0xF0) return 3;
+		if (lead < 0xF8) return 4;
+		return 1;
+	}
+
+	inline bool IsUTF8Continuation(uint8_t ch) {
+		return (ch & 0xC0) == 0x80;
+	}
+
+	// Whether the UTF-8 character "ch" (which is "chLength" bytes) is one of the characters in "set". The set is gone through a whole character at a time, so only the exact same sequence counts.
+	template<typename T>
+	bool UTF8SetContains(T* set, uint16_t setLength, T* ch, uint8_t chLength) {
+		for (uint16_t i = 0; i < setLength;) {
+			uint16_t currentLength = UTF8CharacterLength((uint8_t)set[i]);
+			if (currentLength > setLength - i) currentLength = setLength - i;
+
+			if (Matches(set + i, ch, currentLength, chLength))
+				return true;
+
+			i += currentLength;
+		}
+
+		return false;
+	}
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef _ABPARSER_INCLUDE_MEMO_H
+#define _ABPARSER_INCLUDE_MEMO_H
+#include "ABParserHelpers.h"
+#include "ABParserConfig.h"
+#include <unordered_map>
+#include <vector>
+
+namespace abparser {
+
+	// SEE ABSOFTWARE DOCS:
+	// Remembers what the parser found in pieces of text it's already been through, so that when the exact same piece comes up again under the same token limit (like the same key or string
+	// showing up over and over in a document), it can give the same token straight away instead of going through every character again.
+	// A piece is only remembered when the parser had nothing still in progress at both ends of it (no tokens being collected or verified), as that's when what it finds only depends on the
+	// current token limit and the text in that piece. The trivia is still worked out from the text each time, so trivia limits don't affect it.
+	// This is opt-in - set it as a parser's "Memo" (a memo can be shared between several parsers with the same configuration, one at a time). It's kept across texts.
+	template<typename T, typename U = char>
+	class ABParserMemo {
+	public:
+		ABParserConfiguration<T, U>* Configuration;
+
+		// Once there are this many pieces remembered, no more get added.
+		size_t MaxEntries;
+
+		// Pieces longer than this aren't remembered.
+		uint32_t MaxSpanLength;
+
+		uint64_t Hits;
+		uint64_t Misses;
+
+		ABParserMemo(ABParserConfiguration<T, U>* configuration, size_t maxEntries = 4096, uint32_t maxSpanLength = 4096) {
+			configuration->AddReference();
+			Configuration = configuration;
+
+			MaxEntries = maxEntries;
+			MaxSpanLength = maxSpanLength;
+
+			Hits = Misses = 0;
+		}
+
+		~ABParserMemo() {
+			Configuration->Release();
+		}
+
+		void Clear() {
+			entries.clear();
+		}
+
+		// Looks for a piece starting at "text" that's been seen under "limit" before. "maxLength" is how much text there is to look at.
+		bool TryGet(TokenLimit<T>* limit, T* text, uint32_t maxLength, uint64_t key, ABParserInternalToken<T>*& token, uint32_t& tokenOffset, uint32_t& tokenLength, uint32_t& spanLength) {
+			auto item = entries.find(key);
+
+			if (item == entries.end() || item->second.Limit != limit || item->second.Span.size() > maxLength || !Matches(item->second.Span.data(), text, item->second.Span.size(), item->second.Span.size())) {
+				Misses++;
+				return false;
+			}
+
+			token = item->second.Token;
+			tokenOffset = item->second.TokenOffset;
+			tokenLength = item->second.TokenLength;
+			spanLength = (uint32_t)item->second.Span.size();
+
+			Hits++;
+			return true;
+		}
+
+		void Add(TokenLimit<T>* limit, T* text, uint32_t spanLength, uint64_t key, ABParserInternalToken<T>* token, uint32_t tokenOffset, uint32_t tokenLength) {
+			if (spanLength > MaxSpanLength) return;
+
+			auto item = entries.find(key);
+			if (item == entries.end() && entries.size() >= MaxEntries) return;
+
+			Entry& entry = item == entries.end() ? entries[key] : item->second;
+			entry.Limit = limit;
+			entry.Span.assign(text, text + spanLength);
+			entry.Token = token;
+			entry.TokenOffset = tokenOffset;
+			entry.TokenLength = tokenLength;
+		}
+
+		// Pieces are found by their limit and the first few characters - the rest of the piece is compared when one's found.
+		static uint64_t GetKey(TokenLimit<T>* limit, T* text, uint32_t maxLength) {
+			uint32_t length = maxLength < KeyLength ? maxLength : KeyLength;
+
+			uint64_t hash = 0xCBF29CE484222325 ^ (uint64_t)(uintptr_t)limit;
+			for (uint32_t i = 0; i < length; i++) {
+				hash ^= (uint64_t)text[i];
+				hash *= 0x100000001B3;
+			}
+
+			return hash ^ length;
+		}
+
+	private:
+		static const uint32_t KeyLength = 16;
+
+		class Entry {
+		public:
+			TokenLimit<T>* Limit = nullptr;
+			std::vector<T> Span;
+
+			ABParserInternalToken<T>* Token = nullptr;
+			uint32_t TokenOffset = 0;
+			uint32_t TokenLength = 0;
+		};
+
+		std::unordered_map<uint64_t, Entry> entries;
+	};
+}
+#endif
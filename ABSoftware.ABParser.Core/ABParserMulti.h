@@ -0,0 +1,100 @@
+#ifndef _ABPARSER_INCLUDE_MULTI_H
+#define _ABPARSER_INCLUDE_MULTI_H
+#include "ABParserBase.h"
+#include <vector>
+
+namespace abparser {
+
+	// Runs several parsers (usually each with a different configuration) over the same text together, rather than each one going through the whole text by itself.
+	// None of them copy the text - they all parse it where it is. They go through it a window at a time: each parser runs up to the end of the window before the next one has a go,
+	// so that piece of the text is still in the cache when they get to it. Before every window, the first place any of their tokens could start is looked for just once,
+	// and any parser with nothing in progress is moved straight on to there.
+	// Each parser still has its own limits, subscriptions and so on, and gives exactly the same results, in the same order, as it would by itself.
+	template<typename T, typename U = char>
+	class ABParserMulti {
+	public:
+		// These aren't owned by this.
+		std::vector<ABParserBase<T, U>*> Parsers;
+
+		// How much of the text each parser goes through before the next one takes over (0 to go through the whole text in one go).
+		uint32_t WindowSize;
+
+		ABParserMulti(uint32_t windowSize = 16384) {
+			WindowSize = windowSize;
+		}
+
+		virtual ~ABParserMulti() {}
+
+		void AddParser(ABParserBase<T, U>* parser) {
+			Parsers.push_back(parser);
+		}
+
+		// Parses "text" with all of the parsers. It isn't copied, so it needs to stay where it is (and not change) until this has finished.
+		// If any of them get cancelled or run past their deadline (see "ABParserBase::CharacterBudget"), all of them are abandoned, and this gives false.
+		bool Run(const T* text, uint32_t textLength) {
+			tokenStarts.Clear();
+			for (size_t i = 0; i < Parsers.size(); i++) {
+				Parsers[i]->InitSharedString(text, textLength);
+				tokenStarts.Add(Parsers[i]->Configuration->TokenStarts);
+			}
+
+			finished.assign(Parsers.size(), false);
+			size_t remaining = Parsers.size();
+			uint32_t windowStart = 0;
+
+			while (remaining) {
+				uint32_t windowEnd = WindowSize && textLength - windowStart > WindowSize ? windowStart + WindowSize : UINT32_MAX;
+				uint32_t next = tokenStarts.FindNext(text, windowStart, windowEnd < textLength ? windowEnd : textLength);
+
+				for (size_t i = 0; i < Parsers.size(); i++) {
+					if (finished[i]) continue;
+					ABParserBase<T, U>* parser = Parsers[i];
+
+					// (If it gave up before the window because of its own budget, it hasn't seen everything up to here yet)
+					if (parser->InternalPosition >= windowStart) parser->SkipTo(next);
+					parser->PauseAt = windowEnd;
+
+					ABParserResult result;
+					while ((result = parser->ContinueExecution()) != ABParserResult::Yielded) {
+						if (result == ABParserResult::None) continue;
+						OnResult(i, result);
+
+						if (result == ABParserResult::StopAndFinalOnTokenProcessed) {
+							parser->PauseAt = UINT32_MAX;
+							finished[i] = true;
+							remaining--;
+							break;
+						}
+					}
+
+					if (result == ABParserResult::Yielded && parser->ShouldAbandonParse()) {
+						AbandonAll();
+						return false;
+					}
+				}
+
+				if (windowEnd != UINT32_MAX) windowStart = windowEnd;
+			}
+
+			return true;
+		}
+
+		// Given every result from each of the parsers, apart from "None" and "Yielded" - "parser" is where it is in "Parsers". Its "CurrentEvent..." and trivia are set up just like they
+		// would be straight after "ContinueExecution", and its limits can be changed from here too.
+		virtual void OnResult(size_t parser, ABParserResult result) {}
+
+	private:
+		FirstCharacterScanner<T> tokenStarts;
+		std::vector<bool> finished;
+
+		void AbandonAll() {
+			for (size_t i = 0; i < Parsers.size(); i++) {
+				if (finished[i]) continue;
+
+				Parsers[i]->ResetParseState();
+				Parsers[i]->PauseAt = UINT32_MAX;
+			}
+		}
+	};
+}
+#endif
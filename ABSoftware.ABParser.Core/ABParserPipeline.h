@@ -0,0 +1,101 @@
+#ifndef _ABPARSER_INCLUDE_PIPELINE_H
+#define _ABPARSER_INCLUDE_PIPELINE_H
+#include "ABParserHelpers.h"
+#include <atomic>
+#include <thread>
+
+namespace abparser {
+
+	// One result from "ContinueExecution", kept small so it can be passed between threads cheaply. The trivia is only a span of the text, as the text doesn't change during a parse.
+	template<typename T>
+	class ABParserEventRecord {
+	public:
+		ABParserResult Result = ABParserResult::None;
+
+		// Not set for "OnFirstUnlimitedCharacterProcessed" or "StopAndFinalOnTokenProcessed".
+		uint32_t TokenIndex = 0;
+		uint32_t TokenStart = 0;
+		uint32_t TokenLength = 0;
+
+		// For "OnFirstUnlimitedCharacterProcessed", "TriviaStart" is the position it was at instead.
+		uint32_t TriviaStart = 0;
+		uint32_t TriviaLength = 0;
+
+		// The trivia limit that still needs to be applied to the trivia, if there was one.
+		TriviaLimit<T>* ActiveTriviaLimit = nullptr;
+	};
+
+	// A bounded queue for exactly one thread putting items in and one thread taking them out, without any locks.
+	// Each side keeps its own copy of where the other side was last seen, so it only has to look at the other side's position (and its cache line) when the queue looks full or empty.
+	template<typename T>
+	class ABParserEventQueue {
+	public:
+
+		// This gets rounded up to a power of two.
+		ABParserEventQueue(size_t capacity) {
+			size = 1;
+			while (size < capacity) size <<= 1;
+
+			mask = size - 1;
+			items = new T[size];
+
+			head.store(0, std::memory_order_relaxed);
+			tail.store(0, std::memory_order_relaxed);
+			cachedHead = cachedTail = 0;
+		}
+
+		~ABParserEventQueue() {
+			delete[] items;
+		}
+
+		ABParserEventQueue(const ABParserEventQueue&) = delete;
+		ABParserEventQueue& operator=(const ABParserEventQueue&) = delete;
+
+		// Only ever called from the thread putting items in - false if it's full.
+		bool TryPush(const T& item) {
+			size_t currentTail = tail.load(std::memory_order_relaxed);
+
+			if (currentTail - cachedHead == size) {
+				cachedHead = head.load(std::memory_order_acquire);
+				if (currentTail - cachedHead == size) return false;
+			}
+
+			items[currentTail & mask] = item;
+			tail.store(currentTail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Only ever called from the thread taking items out - false if it's empty.
+		bool TryPop(T& item) {
+			size_t currentHead = head.load(std::memory_order_relaxed);
+
+			if (currentHead == cachedTail) {
+				cachedTail = tail.load(std::memory_order_acquire);
+				if (currentHead == cachedTail) return false;
+			}
+
+			item = items[currentHead & mask];
+			head.store(currentHead + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		T* items;
+		size_t size;
+		size_t mask;
+
+		// The two sides are kept on separate cache lines, so they aren't fighting over the same one every time either of them moves.
+		alignas(64) std::atomic<size_t> tail;
+		size_t cachedHead;
+
+		alignas(64) std::atomic<size_t> head;
+		size_t cachedTail;
+	};
+
+	// Waits a little before trying something again - it just spins at first, as the other side is usually only a moment away, and then gives up the rest of its time slice.
+	inline void ABParserPipelineWait(uint32_t& attempts) {
+		if (++attempts < 64) return;
+		std::this_thread::yield();
+	}
+}
+#endif
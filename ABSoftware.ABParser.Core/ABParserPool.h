@@ -0,0 +1,135 @@
+#ifndef _ABPARSER_INCLUDE_POOL_H
+#define _ABPARSER_INCLUDE_POOL_H
+#include "ABParserBase.h"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+namespace abparser {
+
+	// Keeps hold of parsers for a configuration once they're finished with, so that making a parser for every request doesn't mean allocating all of its buffers every time.
+	// Any thread can acquire and release parsers. Each thread keeps a few released parsers to itself, so that it only has to lock the shared pool when it runs out (or has too many).
+	template<typename T, typename U = char>
+	class ABParserPool {
+	public:
+		ABParserConfiguration<T, U>* Configuration;
+
+		// How many released parsers can be kept in the shared pool, and in each thread's own cache, before any more are just deleted.
+		size_t MaxIdleParsers;
+		size_t MaxParsersPerThread;
+
+		// Parsers that have been used on a text longer than this get their buffers freed when they're released, so one huge text doesn't keep that much memory around forever.
+		uint32_t MaxRetainedTextLength;
+
+		ABParserPool(ABParserConfiguration<T, U>* configuration, size_t maxIdleParsers = 64, size_t maxParsersPerThread = 4, uint32_t maxRetainedTextLength = 1 << 20) {
+			configuration->AddReference();
+			Configuration = configuration;
+
+			MaxIdleParsers = maxIdleParsers;
+			MaxParsersPerThread = maxParsersPerThread;
+			MaxRetainedTextLength = maxRetainedTextLength;
+
+			id = NextPoolId();
+		}
+
+		// Every thread's cache belongs to the pool, so all of the parsers kept go with it. No thread can still be using the pool by now.
+		~ABParserPool() {
+			for (size_t i = 0; i < idleParsers.size(); i++)
+				delete idleParsers[i];
+
+			threadCaches.clear();
+			Configuration->Release();
+		}
+
+		ABParserBase<T, U>* Acquire() {
+			std::vector<ABParserBase<T, U>*>& threadParsers = GetThreadCache().Parsers;
+
+			if (!threadParsers.empty()) {
+				ABParserBase<T, U>* parser = threadParsers.back();
+				threadParsers.pop_back();
+				return parser;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(idleParsersLock);
+
+				if (!idleParsers.empty()) {
+					ABParserBase<T, U>* parser = idleParsers.back();
+					idleParsers.pop_back();
+					return parser;
+				}
+			}
+
+			return new ABParserBase<T, U>(Configuration);
+		}
+
+		// Gives a parser back to the pool. It doesn't need to have finished parsing, only the parse state is reset - the buffers are kept for the next text.
+		void Release(ABParserBase<T, U>* parser) {
+			parser->ResetParseState();
+			parser->DisposeDataForNextParse();
+
+			if (parser->TextCapacity > MaxRetainedTextLength)
+				parser->DisposeForTextChange();
+
+			std::vector<ABParserBase<T, U>*>& threadParsers = GetThreadCache().Parsers;
+			if (threadParsers.size() < MaxParsersPerThread) {
+				threadParsers.push_back(parser);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(idleParsersLock);
+
+				if (idleParsers.size() < MaxIdleParsers) {
+					idleParsers.push_back(parser);
+					return;
+				}
+			}
+
+			delete parser;
+		}
+
+	private:
+		std::mutex idleParsersLock;
+		std::vector<ABParserBase<T, U>*> idleParsers;
+
+		// One for each thread that's used this pool. Only that thread touches it while the pool's alive, but the pool owns it, so it can delete the parsers in it.
+		class ThreadCache {
+		public:
+			std::vector<ABParserBase<T, U>*> Parsers;
+
+			~ThreadCache() {
+				for (size_t i = 0; i < Parsers.size(); i++)
+					delete Parsers[i];
+			}
+		};
+
+		std::vector<std::unique_ptr<ThreadCache>> threadCaches;
+
+		// Pools are told apart by an ID that's never given out again, rather than their address - so a thread can't mistake a new pool for one that's been deleted.
+		uint64_t id;
+
+		static uint64_t NextPoolId() {
+			static std::atomic<uint64_t> nextId(0);
+			return ++nextId;
+		}
+
+		// Each thread remembers its cache in every pool it's used, so finding it doesn't need the lock. Caches of deleted pools are left behind, but are never looked at again.
+		ThreadCache& GetThreadCache() {
+			static thread_local std::unordered_map<uint64_t, ThreadCache*> caches;
+
+			ThreadCache*& cache = caches[id];
+			if (!cache) {
+				std::lock_guard<std::mutex> lock(idleParsersLock);
+
+				threadCaches.push_back(std::unique_ptr<ThreadCache>(new ThreadCache()));
+				cache = threadCaches.back().get();
+			}
+
+			return *cache;
+		}
+	};
+}
+#endif
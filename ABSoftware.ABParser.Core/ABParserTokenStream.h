@@ -0,0 +1,196 @@
+#ifndef _ABPARSER_INCLUDE_TOKEN_STREAM_H
+#define _ABPARSER_INCLUDE_TOKEN_STREAM_H
+#include "ABParserBase.h"
+#include <stdio.h>
+#include <vector>
+
+namespace abparser {
+
+	// SEE ABSOFTWARE DOCS:
+	// A token stream is a compact record of a parse - just which tokens were found where, and the trivia spans between them, without any of the text itself.
+	// It starts with the 4 bytes "ABPT" and a version byte, and then every token is three LEB128 varints:
+	//     - The token's index (as given to the configuration) plus 1
+	//     - How far the token starts after the end of the previous one (or the start of the text) - which is also the length of the trivia before it
+	//     - The token's length in the text
+	// It finishes with a 0 (where the next token's index would be), followed by a varint of how much trivia is left after the last token.
+	// The trivia is only recorded as spans of the original text, so any trivia limits aren't reflected in it.
+
+	const uint8_t ABParserTokenStreamVersion = 1;
+
+	class ABParserTokenStreamWriter {
+	public:
+		// Where the stream is written to. If "File" is set, the data gets flushed into that as it goes, rather than all being kept here.
+		std::vector<uint8_t> Data;
+		FILE* File;
+
+		ABParserTokenStreamWriter() {
+			File = nullptr;
+		}
+
+		ABParserTokenStreamWriter(FILE* file) {
+			File = file;
+		}
+
+		// Runs a whole parse on "parser", writing every token straight into the stream. There aren't any events, so limits can't be changed part-way through.
+		// The trivia is only recorded as spans, so the parser doesn't need to copy any of it out while this runs. If the parse gets cancelled or runs past its deadline, it's abandoned,
+		// and this gives false, leaving the stream unfinished.
+		template<typename T, typename U>
+		bool WriteParse(ABParserBase<T, U>* parser) {
+			bool locateOnly = parser->LocateOnly;
+			parser->LocateOnly = true;
+
+			Begin();
+
+			ABParserResult result;
+			do {
+				result = parser->ContinueExecution();
+
+				if (result == ABParserResult::Yielded && parser->ShouldAbandonParse()) {
+					parser->ResetParseState();
+					parser->LocateOnly = locateOnly;
+					return false;
+				}
+
+				if (result == ABParserResult::FirstBeforeTokenProcessed || result == ABParserResult::OnThenBeforeTokenProcessed)
+					WriteToken(parser->CurrentEventToken->MixedIdx, parser->CurrentEventTokenStart, parser->CurrentEventTokenLengthInText);
+			} while (result != ABParserResult::StopAndFinalOnTokenProcessed);
+
+			End(parser->TextLength);
+			parser->LocateOnly = locateOnly;
+			return true;
+		}
+
+		// These write a stream a piece at a time, for when the tokens are coming from somewhere else (like "ABParser::StartRecording").
+		// "Begin" starts a new stream, so anything still in "Data" from the last one (or an unfinished one) is thrown away - when writing to a file, it's all been flushed by then anyway.
+		void Begin() {
+			lastEnd = 0;
+			Data.clear();
+
+			Data.push_back('A');
+			Data.push_back('B');
+			Data.push_back('P');
+			Data.push_back('T');
+			Data.push_back(ABParserTokenStreamVersion);
+		}
+
+		void WriteToken(uint32_t tokenIndex, uint32_t start, uint32_t lengthInText) {
+			WriteVarint((uint32_t)tokenIndex + 1);
+			WriteVarint(start - lastEnd);
+			WriteVarint(lengthInText);
+
+			lastEnd = start + lengthInText;
+
+			if (File && Data.size() >= FlushSize) Flush();
+		}
+
+		void End(uint32_t textLength) {
+			WriteVarint(0);
+			WriteVarint(textLength - lastEnd);
+			Flush();
+		}
+
+		void Flush() {
+			if (!File) return;
+
+			fwrite(Data.data(), 1, Data.size(), File);
+			Data.clear();
+		}
+
+	private:
+		static const size_t FlushSize = 1 << 16;
+		uint32_t lastEnd = 0;
+
+		void WriteVarint(uint32_t value) {
+			while (value >= 0x80) {
+				Data.push_back((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+
+			Data.push_back((uint8_t)value);
+		}
+	};
+
+	// Goes through a token stream in place (e.g. straight out of a memory-mapped file), without copying any of it.
+	class ABParserTokenStreamReader {
+	public:
+		// The current token, and the trivia span that came before it.
+		uint32_t TokenIndex;
+		uint32_t TokenStart;
+		uint32_t TokenLength;
+		uint32_t TriviaStart;
+		uint32_t TriviaLength;
+
+		// Once "Next" gives false, this is the trivia span after the last token (or the whole text if there weren't any).
+		uint32_t EndTriviaStart;
+		uint32_t EndTriviaLength;
+
+		ABParserTokenStreamReader(const uint8_t* data, size_t size) {
+			Data = data;
+			End = data + size;
+
+			TokenIndex = 0;
+			TokenStart = TokenLength = TriviaStart = TriviaLength = 0;
+			EndTriviaStart = EndTriviaLength = 0;
+			lastEnd = 0;
+			finished = false;
+
+			IsValid = size >= 5 && data[0] == 'A' && data[1] == 'B' && data[2] == 'P' && data[3] == 'T' && data[4] == ABParserTokenStreamVersion;
+			if (IsValid) Data += 5;
+		}
+
+		// Whether the stream had the right header, and hasn't turned out to be cut off.
+		bool IsValid;
+
+		// Moves onto the next token - false when there aren't any more.
+		bool Next() {
+			if (!IsValid || finished) return false;
+
+			uint32_t index;
+			if (!ReadVarint(index)) return false;
+
+			if (index == 0) {
+				EndTriviaStart = lastEnd;
+				if (!ReadVarint(EndTriviaLength)) return false;
+
+				finished = true;
+				return false;
+			}
+
+			uint32_t distance;
+			if (!ReadVarint(distance) || !ReadVarint(TokenLength)) return false;
+
+			TokenIndex = index - 1;
+			TriviaStart = lastEnd;
+			TriviaLength = distance;
+			TokenStart = lastEnd + distance;
+
+			lastEnd = TokenStart + TokenLength;
+			return true;
+		}
+
+	private:
+		const uint8_t* Data;
+		const uint8_t* End;
+		uint32_t lastEnd;
+		bool finished;
+
+		bool ReadVarint(uint32_t& value) {
+			value = 0;
+
+			for (int shift = 0; shift < 35; shift += 7) {
+				if (Data == End) {
+					IsValid = false;
+					return false;
+				}
+
+				uint8_t current = *Data++;
+				value |= (uint32_t)(current & 0x7F) << shift;
+				if (!(current & 0x80)) return true;
+			}
+
+			IsValid = false;
+			return false;
+		}
+	};
+}
+#endif
@@ -9,7 +9,7 @@
 
 class TestParser : public abparser::ABParser<wchar_t> {
 public:
-	TestParser(abparser::ABParserConfiguration<wchar_t>* config, abparser::ABParserToken<wchar_t>* tokens) : ABParser(config, tokens) {}
+	TestParser(abparser::ABParserConfiguration<wchar_t>* config) : ABParser(config) {}
 
 	void WriteTokenInformation(const abparser::TokenInformation<wchar_t>* info) {
 
@@ -56,7 +56,7 @@ int main()
 
 	abparser::ABParserConfiguration<wchar_t> config(tokens, 3);
 
-	TestParser parser(&config, tokens);
+	TestParser parser(&config);
 	parser.SetText(L"AtheBtheyCtheyarDtheyareE");
 	parser.Start();
 
@@ -0,0 +1,214 @@
+#ifndef _ABPARSER_INCLUDE_CORE_TESTS_H
+#define _ABPARSER_INCLUDE_CORE_TESTS_H
+#include "ABParser.h"
+#include <initializer_list>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A very small test runner for the core - every "ABP_TEST" registers itself, and "Main.cpp" runs them all. A failed assertion throws, which ends that test (and only that test).
+namespace abparser_tests {
+
+	class TestFailure {
+	public:
+		std::string Message;
+		TestFailure(const std::string& message) : Message(message) {}
+	};
+
+	class TestCase {
+	public:
+		const char* Name;
+		void (*Run)();
+	};
+
+	inline std::vector<TestCase>& GetTests() {
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	class TestRegistration {
+	public:
+		TestRegistration(const char* name, void (*run)()) { GetTests().push_back({ name, run }); }
+	};
+
+	inline std::string Describe(const std::string& str) { return "\"" + str + "\""; }
+	inline std::string Describe(const char* str) { return Describe(std::string(str)); }
+
+	inline std::string Describe(const std::vector<std::string>& items) {
+		std::string result = "{";
+
+		for (size_t i = 0; i < items.size(); i++)
+			result += (i ? ", " : " ") + Describe(items[i]);
+
+		return result + " }";
+	}
+
+	template<typename T>
+	std::string Describe(const T& item) {
+		std::ostringstream result;
+		result << item;
+		return result.str();
+	}
+
+	template<typename A, typename B>
+	void AssertEqual(const A& expected, const B& actual, const char* expression, const char* file, int line) {
+		if (expected == actual) return;
+
+		std::ostringstream message;
+		message << file << ":" << line << ": " << expression << "\n    Expected: " << Describe(expected) << "\n    Actual:   " << Describe(actual);
+		throw TestFailure(message.str());
+	}
+
+	// Makes tokens (each named after its data), for a test to set up further before they're given to a "TestConfiguration".
+	inline abparser::ABParserToken<char>* MakeTokens(std::initializer_list<const char*> data) {
+		abparser::ABParserToken<char>* tokens = new abparser::ABParserToken<char>[data.size()];
+
+		size_t i = 0;
+		for (const char* item : data) {
+			std::string str(item);
+			tokens[i].SetName(str);
+			tokens[i++].SetData(str.data(), (uint16_t)str.size());
+		}
+
+		return tokens;
+	}
+
+	inline void SetTokenLimits(abparser::ABParserToken<char>& token, std::initializer_list<const char*> limits) {
+		token.LimitsLength = (uint16_t)limits.size();
+		token.Limits = new const std::string*[limits.size()];
+
+		size_t i = 0;
+		for (const char* limit : limits)
+			token.Limits[i++] = new const std::string(limit);
+	}
+
+	// Holds the first reference to a configuration, which looks after the tokens it was given. The configuration never deletes its trivia limits, so this does, once it's released.
+	class TestConfiguration {
+	public:
+		abparser::ABParserConfiguration<char>* Configuration;
+		std::vector<abparser::TriviaLimit<char>*> TriviaLimits;
+
+		TestConfiguration(abparser::ABParserToken<char>* tokens, uint32_t numberOfTokens, bool utf8 = false, uint32_t tokenTrieThreshold = 1024) {
+			Configuration = new abparser::ABParserConfiguration<char>();
+			Configuration->IsUTF8 = utf8;
+			Configuration->TokenTrieThreshold = tokenTrieThreshold;
+			Configuration->OwnsTokens = true;
+			Configuration->Init(tokens, numberOfTokens);
+		}
+
+		TestConfiguration(std::initializer_list<const char*> data, bool utf8 = false) : TestConfiguration(MakeTokens(data), (uint32_t)data.size(), utf8) {}
+
+		~TestConfiguration() {
+			Configuration->Release();
+
+			for (size_t i = 0; i < TriviaLimits.size(); i++)
+				delete TriviaLimits[i];
+		}
+
+		TestConfiguration(const TestConfiguration&) = delete;
+		TestConfiguration& operator=(const TestConfiguration&) = delete;
+
+		void AddTriviaLimit(const std::string& name, const std::string& contents, bool isWhitelist) {
+			abparser::TriviaLimit<char>* limit = new abparser::TriviaLimit<char>();
+			limit->DirectSetData((char*)contents.data(), (uint16_t)contents.size());
+			limit->SetIsWhitelist(isWhitelist);
+
+			Configuration->AddTriviaLimit(name, limit);
+			TriviaLimits.push_back(limit);
+		}
+
+		operator abparser::ABParserConfiguration<char>*() const { return Configuration; }
+		abparser::ABParserConfiguration<char>* operator->() const { return Configuration; }
+	};
+
+	inline std::string TokenName(abparser::ABParserBase<char>& parser) {
+		return *parser.Configuration->Tokens[parser.CurrentEventToken->MixedIdx].Name;
+	}
+
+	// Everything that came out of one "ContinueExecution" on the base, as a line of text - e.g. "Token the 1+3 [A]", where the trivia is what came before the token.
+	inline std::string DescribeResult(abparser::ABParserBase<char>& parser, abparser::ABParserResult result) {
+		std::ostringstream line;
+
+		switch (result) {
+		case abparser::ABParserResult::OnFirstUnlimitedCharacterProcessed:
+			line << "FirstUnlimited " << parser.InternalPosition;
+			return line.str();
+		case abparser::ABParserResult::Yielded:
+			return "Yielded";
+		case abparser::ABParserResult::StopAndFinalOnTokenProcessed:
+			line << "End";
+			break;
+		default:
+			line << "Token " << TokenName(parser) << " " << parser.CurrentEventTokenStart << "+" << parser.CurrentEventTokenLengthInText;
+			break;
+		}
+
+		line << " [" << std::string(parser.CurrentTrivia ? parser.CurrentTrivia : "", parser.CurrentTriviaLength) << "]";
+		return line.str();
+	}
+
+	// Runs a whole parse of "text" on the base, giving back every result (apart from "None") described by "DescribeResult". "afterResult" is called after each one, so a test can change limits.
+	inline std::vector<std::string> ParseWithBase(abparser::ABParserBase<char>& parser, const std::string& text, std::function<void(abparser::ABParserResult)> afterResult = nullptr) {
+		std::vector<std::string> log;
+		parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+		abparser::ABParserResult result;
+		do {
+			result = parser.ContinueExecution();
+			if (result == abparser::ABParserResult::None) continue;
+
+			log.push_back(DescribeResult(parser, result));
+			if (afterResult) afterResult(result);
+		} while (result != abparser::ABParserResult::StopAndFinalOnTokenProcessed);
+
+		return log;
+	}
+
+	// Logs the events of a full "ABParser" - "Before <token> <start> [<leading>]", "On <token> [<leading>|<trailing>]" and "End [<leading>]".
+	class TrackingParser : public abparser::ABParser<char> {
+	public:
+		std::vector<std::string> Events;
+
+		std::function<void(TrackingParser&, const std::string&)> OnBefore;
+
+		TrackingParser(abparser::ABParserConfiguration<char>* configuration) : ABParser(configuration) {}
+
+		std::vector<std::string> Parse(const std::string& text) {
+			SetText(text);
+			Start();
+			return Events;
+		}
+
+		void OnStart() override { Events.clear(); }
+
+		void OnEnd(char* leading, uint32_t leadingLength) override {
+			Events.push_back("End [" + std::string(leading ? leading : "", leadingLength) + "]");
+		}
+
+		void BeforeTokenProcessed(const abparser::BeforeTokenProcessedArgs<char>& args) override {
+			const std::string& name = *args.Token->Token->Name;
+			Events.push_back("Before " + name + " " + std::to_string(args.Token->Start) + " [" + std::string(args.Leading ? args.Leading : "", args.LeadingLength) + "]");
+
+			if (OnBefore) OnBefore(*this, name);
+		}
+
+		void OnTokenProcessed(const abparser::OnTokenProcessedArgs<char>& args) override {
+			Events.push_back("On " + *args.Token->Token->Name + " [" + std::string(args.Leading ? args.Leading : "", args.LeadingLength) + "|" + std::string(args.Trailing ? args.Trailing : "", args.TrailingLength) + "]");
+		}
+	};
+}
+
+#define ABP_TEST_JOIN2(a, b) a##b
+#define ABP_TEST_JOIN(a, b) ABP_TEST_JOIN2(a, b)
+
+#define ABP_TEST(name) \
+	static void name(); \
+	static abparser_tests::TestRegistration ABP_TEST_JOIN(name, _registration)(#name, name); \
+	static void name()
+
+#define ABP_ASSERT_EQUAL(expected, actual) abparser_tests::AssertEqual(expected, actual, #actual, __FILE__, __LINE__)
+#define ABP_ASSERT(condition) abparser_tests::AssertEqual(true, (bool)(condition), #condition, __FILE__, __LINE__)
+
+typedef std::vector<std::string> Log;
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+class BatchParser : public TrackingParser {
+public:
+	BatchParser(ABParserConfiguration<char>* configuration) : TrackingParser(configuration) {}
+
+	std::vector<std::string> ParseBatch(const std::string& buffer, const std::vector<uint32_t>& offsets) {
+		StartBatch(buffer.data(), (uint32_t)buffer.size(), offsets.data(), (uint32_t)offsets.size() - 1);
+		return Events;
+	}
+
+	void OnRecordEnd(uint32_t record, char* leading, uint32_t leadingLength) override {
+		Events.push_back("Record " + std::to_string(record) + " [" + std::string(leading, leadingLength) + "]");
+	}
+};
+
+// Runs the rest of a batch on the base, like "ParseWithBase" does for a single parse.
+static std::vector<std::string> ContinueBatch(ABParserBase<char>& parser) {
+	std::vector<std::string> log;
+
+	while (parser.NextRecord()) {
+		ABParserResult result;
+		do {
+			result = parser.ContinueExecution();
+			if (result != ABParserResult::None) log.push_back(DescribeResult(parser, result));
+		} while (result != ABParserResult::StopAndFinalOnTokenProcessed);
+	}
+
+	return log;
+}
+
+ABP_TEST(Batch_RecordsParsedSeparately) {
+	TestConfiguration config({ "A", "BCD" });
+	BatchParser parser(config);
+
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|y]", "Before BCD 3 [y]", "On BCD [y|z]", "Record 0 [z]", "Record 1 []", "Before A 0 []", "On A [|z]", "Record 2 [z]", "End []" }),
+		parser.ParseBatch("xAyBCDzAz", { 0, 7, 7, 9 }));
+}
+
+ABP_TEST(Batch_InvalidOffsets) {
+	TestConfiguration config({ "A", "BCD" });
+	BatchParser parser(config);
+	std::string buffer = "xAyBCDz";
+
+	bool backwardsThrew = false;
+	try { parser.ParseBatch(buffer, { 0, 5, 3, 7 }); }
+	catch (const char*) { backwardsThrew = true; }
+
+	bool pastEndThrew = false;
+	try { parser.ParseBatch(buffer, { 0, 8 }); }
+	catch (const char*) { pastEndThrew = true; }
+
+	ABP_ASSERT(backwardsThrew);
+	ABP_ASSERT(pastEndThrew);
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|y]", "Before BCD 3 [y]", "On BCD [y|z]", "Record 0 [z]", "End []" }), parser.ParseBatch(buffer, { 0, 7 }));
+}
+
+ABP_TEST(Batch_BeginMidParse) {
+	TestConfiguration config({ "A", "BCD" });
+	ABParserBase<char> parser(config);
+
+	// Stops with "BCD" still being verified, which mustn't carry over into the batch.
+	std::string text = "BCxA";
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+	ABP_ASSERT_EQUAL(std::string("FirstUnlimited 0"), DescribeResult(parser, parser.ContinueExecution()));
+
+	std::string buffer = "DzBCDz";
+	std::vector<uint32_t> offsets = { 0, 2, 6 };
+	parser.BeginBatch(buffer.data(), (uint32_t)buffer.size(), offsets.data(), 2);
+
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "End []", "FirstUnlimited 0", "Token BCD 0+3 []", "End [z]" }), ContinueBatch(parser));
+}
\ No newline at end of file
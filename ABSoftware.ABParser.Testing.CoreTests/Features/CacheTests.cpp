@@ -0,0 +1,98 @@
+#include "../CoreTests.h"
+#include "ABParserCache.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// A directory of its own for each test, removed again afterwards.
+class TestCacheDirectory {
+public:
+	std::filesystem::path Path;
+
+	TestCacheDirectory(const char* name) {
+		Path = std::filesystem::temp_directory_path() / ("abparser-cache-tests-" + std::to_string(std::random_device()()) + "-" + name);
+	}
+
+	~TestCacheDirectory() {
+		std::error_code error;
+		std::filesystem::remove_all(Path, error);
+	}
+};
+
+// Enters the token limit "inner" on every "(" - so "b" (which isn't in it) stops being found after one.
+class LimitingParser : public TrackingParser {
+public:
+	LimitingParser(ABParserConfiguration<char>* configuration) : TrackingParser(configuration) {
+		OnBefore = [](TrackingParser& parser, const std::string& name) {
+			if (name == "(") parser.Base.EnterTokenLimit(std::string("inner"));
+		};
+	}
+};
+
+static ABParserToken<char>* MakeLimitedTokens() {
+	ABParserToken<char>* tokens = MakeTokens({ "(", "a", "b" });
+	SetTokenLimits(tokens[1], { "inner" });
+	return tokens;
+}
+
+ABP_TEST(Cache_ReplaysSameEvents) {
+	TestCacheDirectory directory("replay");
+	TestConfiguration config({ "a", "bc" });
+	ABParserCache<char> cache(directory.Path);
+
+	TrackingParser parser(config);
+	parser.SetText("xaybcz");
+
+	ABP_ASSERT(!cache.Start(parser));
+	Log parsed = parser.Events;
+
+	ABP_ASSERT(cache.Start(parser));
+	ABP_ASSERT_EQUAL(parsed, parser.Events);
+}
+
+ABP_TEST(Cache_KeptByParserType) {
+	TestCacheDirectory directory("type");
+	TestConfiguration config(MakeLimitedTokens(), 3);
+	ABParserCache<char> cache(directory.Path);
+	std::string text = "b(ab";
+
+	TrackingParser plain(config);
+	plain.SetText(text);
+	ABP_ASSERT(!cache.Start(plain));
+
+	LimitingParser limiting(config);
+	limiting.SetText(text);
+	ABP_ASSERT(!cache.Start(limiting));
+
+	LimitingParser solo(config);
+	ABP_ASSERT_EQUAL(solo.Parse(text), limiting.Events);
+	ABP_ASSERT(plain.Events != limiting.Events);
+
+	ABP_ASSERT(cache.Start(limiting));
+	ABP_ASSERT_EQUAL(solo.Events, limiting.Events);
+}
+
+ABP_TEST(Cache_KeptBySalt) {
+	TestCacheDirectory directory("salt");
+	TestConfiguration config({ "a" });
+	ABParserCache<char> cache(directory.Path);
+
+	TrackingParser parser(config);
+	parser.SetText("1a2");
+	ABP_ASSERT(!cache.Start(parser));
+
+	cache.Salt = "other";
+	ABP_ASSERT(!cache.Start(parser));
+	ABP_ASSERT(cache.Start(parser));
+}
+
+ABP_TEST(Cache_EvictsDownToMaxSize) {
+	TestCacheDirectory directory("evict");
+	TestConfiguration config({ "a" });
+	ABParserCache<char> cache(directory.Path, 0);
+
+	TrackingParser parser(config);
+	parser.SetText("1a2");
+	ABP_ASSERT(!cache.Start(parser));
+	ABP_ASSERT(!cache.Start(parser));
+	ABP_ASSERT(std::filesystem::is_empty(directory.Path));
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+ABP_TEST(Configuration_SharedWithParsers) {
+	TestConfiguration config({ "A" });
+	ABP_ASSERT(!config->IsShared());
+
+	{
+		ABParserBase<char> parser(config);
+		ABP_ASSERT(config->IsShared());
+	}
+
+	ABP_ASSERT(!config->IsShared());
+}
+
+ABP_TEST(Configuration_TriviaLimitsOnlyBeforeShared) {
+	ABParserToken<char>* tokens = MakeTokens({ "<", ">" });
+	tokens[0].SetEntersTriviaLimit("NoSpaces");
+	tokens[1].SetExitsTriviaLimit("NoSpaces");
+
+	TestConfiguration config(tokens, 2);
+	config.AddTriviaLimit("NoSpaces", " ", false);
+
+	ABParserBase<char> parser(config);
+
+	// Once a parser has it, it can't be changed any more - the limit that was there before still works.
+	TriviaLimit<char> limit;
+	bool threw = false;
+	try { config->AddTriviaLimit("Other", &limit); }
+	catch (const char*) { threw = true; }
+
+	ABP_ASSERT(threw);
+	ABP_ASSERT_EQUAL(1u, (uint32_t)config->TriviaLimits.size());
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token < 0+1 []", "Token > 5+1 [ab]", "End [ c]" }), ParseWithBase(parser, "< a b> c"));
+}
\ No newline at end of file
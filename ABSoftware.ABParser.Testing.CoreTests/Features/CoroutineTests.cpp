@@ -0,0 +1,96 @@
+#include "../CoreTests.h"
+#include "ABParserCoroutine.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+#ifdef _ABP_HAS_COROUTINES
+
+// Gives the events in the same form as "DescribeResult" does, so they can be compared with running the base directly.
+static std::string DescribeEvent(ABParserBase<char>& parser, const ABParserEvent<char>& event) {
+	switch (event.Result) {
+	case ABParserResult::OnFirstUnlimitedCharacterProcessed:
+		return "FirstUnlimited " + std::to_string(event.Position);
+	case ABParserResult::Yielded:
+		return "Yielded";
+	default:
+		break;
+	}
+
+	std::string line = event.Token ? "Token " + *parser.Configuration->Tokens[event.Token->MixedIdx].Name + " " + std::to_string(event.TokenStart) + "+" + std::to_string(event.TokenLengthInText) : "End";
+	return line + " [" + std::string(event.Trivia ? event.Trivia : "", event.TriviaLength) + "]";
+}
+
+ABP_TEST(Coroutine_SameEventsAsContinueExecution) {
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = "xaybcdzbcw";
+
+	ABParserBase<char> direct(config);
+	Log expected = ParseWithBase(direct, text);
+
+	ABParserBase<char> parser(config);
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+	Log actual;
+	ABParserEventStream<char> events = ParseEvents(&parser);
+	while (events.Next())
+		actual.push_back(DescribeEvent(parser, events.Current()));
+
+	ABP_ASSERT_EQUAL(expected, actual);
+}
+
+ABP_TEST(Coroutine_ParserWaitsForConsumer) {
+	TestConfiguration config({ "a" });
+	std::string text = "1a2a3";
+
+	ABParserBase<char> parser(config);
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+	ABParserEventStream<char> events = ParseEvents(&parser);
+	ABP_ASSERT(events.Next());
+	ABP_ASSERT(events.Next());
+	ABP_ASSERT_EQUAL("Token a 1+1 [1]", DescribeEvent(parser, events.Current()));
+
+	// Nothing past the first token has been looked at while the consumer isn't asking.
+	ABP_ASSERT(parser.InternalPosition < 3);
+
+	ABP_ASSERT(events.Next());
+	ABP_ASSERT_EQUAL("Token a 3+1 [2]", DescribeEvent(parser, events.Current()));
+}
+
+ABP_TEST(Coroutine_YieldsOnBudget) {
+	TestConfiguration config({ "a" });
+	std::string text = "0123456789a";
+
+	ABParserBase<char> parser(config);
+	parser.CharacterBudget = 4;
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+	int yields = 0;
+	ABParserEventStream<char> events = ParseEvents(&parser);
+	while (events.Next())
+		if (events.Current().Result == ABParserResult::Yielded)
+			yields++;
+
+	ABP_ASSERT(yields >= 2);
+}
+
+ABP_TEST(Coroutine_DroppedStreamThenReset) {
+	TestConfiguration config({ "a" });
+	std::string text = "1a2a3";
+
+	ABParserBase<char> parser(config);
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+	{
+		ABParserEventStream<char> events = ParseEvents(&parser);
+		ABP_ASSERT(events.Next());
+		ABP_ASSERT(events.Next());
+	}
+
+	parser.ResetParseState();
+
+	ABParserBase<char> fresh(config);
+	ABP_ASSERT_EQUAL(ParseWithBase(fresh, "bab"), ParseWithBase(parser, "bab"));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+static ABParserToken<char>* MakeSelectTokens() {
+	ABParserToken<char>* tokens = MakeTokens({ "select", "from", "x" });
+	tokens[0].SetIgnoreCase(true);
+	tokens[2].SetIgnoreCase(true);
+	return tokens;
+}
+
+ABP_TEST(IgnoreCase_OnlyForThoseTokens) {
+	TestConfiguration config(MakeSelectTokens(), 3);
+	ABParserBase<char> parser(config);
+
+	// The trivia (and the text) stay exactly as they were given.
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token select 0+6 []", "Token x 7+1 [ ]", "Token select 9+6 [ ]", "End [ FROM]" }), ParseWithBase(parser, "SeLeCt X select FROM"));
+	ABP_ASSERT_EQUAL(std::string("SeLeCt X select FROM"), std::string(parser.Text, parser.TextLength));
+}
+
+ABP_TEST(IgnoreCase_WithTokenTrie) {
+	ABParserToken<char>* tokens = MakeSelectTokens();
+	TestConfiguration config(tokens, 3, false, 0);
+	ABP_ASSERT(config->MultiCharTrie != nullptr);
+
+	ABParserBase<char> parser(config);
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token select 0+6 []", "Token x 7+1 [ ]", "Token from 9+4 [ ]", "End [ FROm]" }), ParseWithBase(parser, "SELECT x from FROm"));
+}
+
+ABP_TEST(IgnoreCase_WideCharacters) {
+	std::u16string data[] = { u"αβγ", u"ж" };
+
+	ABParserToken<char16_t>* tokens = new ABParserToken<char16_t>[2];
+	for (int i = 0; i < 2; i++) {
+		tokens[i].SetData(data[i].data(), (uint16_t)data[i].size());
+		tokens[i].SetIgnoreCase(true);
+	}
+
+	ABParserConfiguration<char16_t>* config = new ABParserConfiguration<char16_t>();
+	config->OwnsTokens = true;
+	config->Init(tokens, 2);
+
+	// Greek and Cyrillic capitals fold to their small letters.
+	std::u16string text = u"-ΑΒγ-Ж";
+
+	ABParserBase<char16_t>* parser = new ABParserBase<char16_t>(config);
+	parser->InitString(text.data(), (uint32_t)text.size());
+
+	std::vector<uint32_t> found;
+	ABParserResult result;
+	do {
+		result = parser->ContinueExecution();
+		if (result == ABParserResult::FirstBeforeTokenProcessed || result == ABParserResult::OnThenBeforeTokenProcessed) {
+			found.push_back(parser->CurrentEventToken->MixedIdx);
+			found.push_back(parser->CurrentEventTokenStart);
+		}
+	} while (result != ABParserResult::StopAndFinalOnTokenProcessed);
+
+	delete parser;
+	config->Release();
+
+	ABP_ASSERT(found == std::vector<uint32_t>({ 0, 1, 1, 5 }));
+}
\ No newline at end of file
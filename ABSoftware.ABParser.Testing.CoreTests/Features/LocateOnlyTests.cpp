@@ -0,0 +1,29 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+ABP_TEST(LocateOnly_SameTokensWithoutTrivia) {
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = "xaybcdzbcw";
+
+	ABParserBase<char> parser(config);
+	parser.LocateOnly = true;
+
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token a 1+1 []", "Token bcd 3+3 []", "Token bc 7+2 []", "End []" }), ParseWithBase(parser, text));
+	ABP_ASSERT(parser.CurrentTrivia == nullptr);
+
+	// The trivia is still found, just never copied out.
+	ABP_ASSERT_EQUAL(9u, parser.CurrentTriviaStart);
+	ABP_ASSERT_EQUAL(1u, parser.CurrentTriviaSpanLength);
+}
+
+ABP_TEST(LocateOnly_TurnedOffAgain) {
+	TestConfiguration config({ "a" });
+	TrackingParser parser(config);
+
+	parser.Base.LocateOnly = true;
+	ABP_ASSERT_EQUAL(Log({ "Before a 1 []", "On a [|]", "End []" }), parser.Parse("1a2"));
+
+	parser.Base.LocateOnly = false;
+	ABP_ASSERT_EQUAL(Log({ "Before a 1 [1]", "On a [1|2]", "End [2]" }), parser.Parse("1a2"));
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// Enters the token limit "inner" after every "(", and exits it after every ")".
+static std::function<void(ABParserResult)> FollowBrackets(ABParserBase<char>& parser) {
+	return [&parser](ABParserResult result) {
+		if (result != ABParserResult::FirstBeforeTokenProcessed && result != ABParserResult::OnThenBeforeTokenProcessed) return;
+
+		std::string name = TokenName(parser);
+		if (name == "(") parser.EnterTokenLimit(std::string("inner"));
+		else if (name == ")") parser.ExitTokenLimit();
+	};
+}
+
+static ABParserToken<char>* MakeBracketTokens() {
+	ABParserToken<char>* tokens = MakeTokens({ "(", ")", "key", "ke" });
+	SetTokenLimits(tokens[1], { "inner" });
+	SetTokenLimits(tokens[3], { "inner" });
+	return tokens;
+}
+
+ABP_TEST(Memo_SameResultsAsWithout) {
+	TestConfiguration config({ "key", "ke", "=", ";" });
+	std::string text = "key=1; kex=2; key=1; kex=2; key=1;";
+
+	ABParserBase<char> plain(config);
+	Log expected = ParseWithBase(plain, text);
+
+	ABParserMemo<char> memo(config);
+	ABParserBase<char> parser(config);
+	parser.Memo = &memo;
+
+	ABP_ASSERT_EQUAL(expected, ParseWithBase(parser, text));
+	ABP_ASSERT(memo.Hits > 0);
+
+	// It's kept across texts, so parsing it again is mostly hits (only the pieces that didn't finish with nothing in progress miss).
+	uint64_t hits = memo.Hits, misses = memo.Misses;
+	ABP_ASSERT_EQUAL(expected, ParseWithBase(parser, text));
+	ABP_ASSERT(memo.Hits - hits > memo.Misses - misses);
+}
+
+ABP_TEST(Memo_KeptByTokenLimit) {
+	TestConfiguration config(MakeBracketTokens(), 4);
+	std::string text = "key(key)key(key)key";
+
+	ABParserBase<char> plain(config);
+	Log expected = ParseWithBase(plain, text, FollowBrackets(plain));
+
+	ABParserMemo<char> memo(config);
+	ABParserBase<char> parser(config);
+	parser.Memo = &memo;
+
+	// "key" is the same text both inside and outside the brackets, but only "ke" is found inside - so neither can be given for the other.
+	ABP_ASSERT_EQUAL(expected, ParseWithBase(parser, text, FollowBrackets(parser)));
+	ABP_ASSERT_EQUAL(expected, ParseWithBase(parser, text, FollowBrackets(parser)));
+	ABP_ASSERT(memo.Hits > 0);
+}
+
+ABP_TEST(Memo_IgnoredForOtherConfigurations) {
+	TestConfiguration config({ "ab" });
+	TestConfiguration other({ "b" });
+
+	ABParserMemo<char> memo(config);
+	ABParserBase<char> first(config);
+	first.Memo = &memo;
+	ParseWithBase(first, "xabx");
+
+	ABParserBase<char> parser(other);
+	parser.Memo = &memo;
+
+	ABParserBase<char> plain(other);
+	ABP_ASSERT_EQUAL(ParseWithBase(plain, "xabx"), ParseWithBase(parser, "xabx"));
+}
\ No newline at end of file
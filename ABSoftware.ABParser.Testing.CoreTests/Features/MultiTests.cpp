@@ -0,0 +1,111 @@
+#include "../CoreTests.h"
+#include "ABParserMulti.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// Logs the results of every parser separately, as well as all of them together in the order they came in (as "<parser>: <result>").
+class LoggingMulti : public ABParserMulti<char> {
+public:
+	std::vector<std::vector<std::string>> Logs;
+	std::vector<std::string> Combined;
+
+	LoggingMulti(uint32_t windowSize) : ABParserMulti(windowSize) {}
+
+	bool Run(const std::string& text) {
+		Logs.assign(Parsers.size(), std::vector<std::string>());
+		Combined.clear();
+
+		return ABParserMulti::Run(text.data(), (uint32_t)text.size());
+	}
+
+	void OnResult(size_t parser, ABParserResult result) override {
+		std::string line = DescribeResult(*Parsers[parser], result);
+
+		Logs[parser].push_back(line);
+		Combined.push_back(std::to_string(parser) + ": " + line);
+	}
+};
+
+ABP_TEST(Multi_MatchesSoloParses) {
+	TestConfiguration first({ "A", "BCD", "BCE" });
+	TestConfiguration second({ "C", "xy" });
+
+	std::string text = "xxABCExyzzBCDCzzzzxyBC";
+	for (uint32_t windowSize : { 0u, 1u, 3u, 8u }) {
+		ABParserBase<char> firstParser(first), secondParser(second);
+
+		LoggingMulti multi(windowSize);
+		multi.AddParser(&firstParser);
+		multi.AddParser(&secondParser);
+		ABP_ASSERT(multi.Run(text));
+
+		ABParserBase<char> firstSolo(first), secondSolo(second);
+		ABP_ASSERT_EQUAL(ParseWithBase(firstSolo, text), multi.Logs[0]);
+		ABP_ASSERT_EQUAL(ParseWithBase(secondSolo, text), multi.Logs[1]);
+	}
+}
+
+ABP_TEST(Multi_LimitsChangedFromResults) {
+	ABParserToken<char>* tokens = MakeTokens({ "(", ")", "A" });
+	tokens[0].SetEntersTriviaLimit("NoSpaces");
+	tokens[1].SetExitsTriviaLimit("NoSpaces");
+
+	TestConfiguration config(tokens, 3);
+	config.AddTriviaLimit("NoSpaces", " ", false);
+
+	std::string text = "x ( a b ) A c ( d )";
+	ABParserBase<char> parser(config);
+
+	LoggingMulti multi(4);
+	multi.AddParser(&parser);
+	ABP_ASSERT(multi.Run(text));
+
+	ABParserBase<char> solo(config);
+	ABP_ASSERT_EQUAL(ParseWithBase(solo, text), multi.Logs[0]);
+}
+
+ABP_TEST(Multi_BudgetStillFillsWindow) {
+	TestConfiguration first({ "a", "A" });
+	TestConfiguration second({ "C" });
+
+	// "A" is in the first window and "C" is in the second, so "A" should come first, even though the first parser yields every 2 characters.
+	std::string text = "axxxxxAxxxxxxxCx";
+	ABParserBase<char> firstParser(first), secondParser(second);
+	firstParser.CharacterBudget = 2;
+	firstParser.YieldCheckInterval = 1;
+
+	LoggingMulti multi(8);
+	multi.AddParser(&firstParser);
+	multi.AddParser(&secondParser);
+	ABP_ASSERT(multi.Run(text));
+
+	size_t a = std::find(multi.Combined.begin(), multi.Combined.end(), "0: Token A 6+1 [xxxxx]") - multi.Combined.begin();
+	size_t c = std::find(multi.Combined.begin(), multi.Combined.end(), "1: Token C 14+1 [axxxxxAxxxxxxx]") - multi.Combined.begin();
+	ABP_ASSERT(a < multi.Combined.size());
+	ABP_ASSERT(c < multi.Combined.size());
+	ABP_ASSERT(a < c);
+
+	ABParserBase<char> firstSolo(first);
+	ABP_ASSERT_EQUAL(ParseWithBase(firstSolo, text), multi.Logs[0]);
+}
+
+ABP_TEST(Multi_Cancelled) {
+	TestConfiguration config({ "A" });
+	std::atomic<bool> cancelled(true);
+
+	ABParserBase<char> first(config), second(config);
+	second.CancellationFlag = &cancelled;
+	second.YieldCheckInterval = 1;
+
+	LoggingMulti multi(4);
+	multi.AddParser(&first);
+	multi.AddParser(&second);
+	ABP_ASSERT(!multi.Run("xAxxAxxxxA"));
+
+	// Both can be used again afterwards.
+	cancelled = false;
+	ABP_ASSERT(multi.Run("xAxxAxxxxA"));
+
+	ABParserBase<char> solo(config);
+	ABP_ASSERT_EQUAL(ParseWithBase(solo, "xAxxAxxxxA"), multi.Logs[1]);
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+static std::string MakeRepeatedText(int times) {
+	std::string text;
+	for (int i = 0; i < times; i++)
+		text += "x" + std::to_string(i) + "a" + (i % 3 ? "bc" : "bcd");
+
+	return text;
+}
+
+class PipelinedParser : public TrackingParser {
+public:
+	PipelinedParser(ABParserConfiguration<char>* configuration) : TrackingParser(configuration) {}
+
+	Log ParsePipelined(const std::string& text, size_t queueCapacity) {
+		SetText(text);
+		StartPipelined(queueCapacity);
+		return Events;
+	}
+};
+
+ABP_TEST(Pipeline_SameEventsInOrder) {
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = MakeRepeatedText(500);
+
+	Log expected = TrackingParser(config).Parse(text);
+
+	// A tiny queue, so the parsing thread keeps having to wait for the events.
+	PipelinedParser parser(config);
+	ABP_ASSERT_EQUAL(expected, parser.ParsePipelined(text, 2));
+	ABP_ASSERT_EQUAL(expected, parser.ParsePipelined(text, 4096));
+}
+
+ABP_TEST(Pipeline_HandlerThrows) {
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = MakeRepeatedText(500);
+
+	PipelinedParser parser(config);
+	int tokens = 0;
+	parser.OnBefore = [&](TrackingParser&, const std::string&) {
+		if (++tokens == 10) throw "Stop";
+	};
+
+	bool threw = false;
+	try {
+		parser.ParsePipelined(text, 4096);
+	} catch (const char*) {
+		threw = true;
+	}
+
+	ABP_ASSERT(threw);
+	ABP_ASSERT_EQUAL(10, tokens);
+
+	// The parsing thread has let go of everything, so the parser can just be used again.
+	parser.OnBefore = nullptr;
+	ABP_ASSERT_EQUAL(TrackingParser(config).Parse(text), parser.ParsePipelined(text, 4096));
+}
+
+ABP_TEST(Pipeline_Cancelled) {
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = MakeRepeatedText(20000);
+	std::atomic<bool> cancelled(false);
+
+	PipelinedParser parser(config);
+	parser.Base.CancellationFlag = &cancelled;
+	// The tokens are closer together than the usual interval, so it'd never get checked.
+	parser.Base.YieldCheckInterval = 1;
+	parser.OnBefore = [&](TrackingParser&, const std::string&) { cancelled.store(true); };
+
+	Log events = parser.ParsePipelined(text, 64);
+	ABP_ASSERT(!events.empty());
+	ABP_ASSERT(events.size() < 1000);
+	ABP_ASSERT(events.back().rfind("End", 0) != 0);
+
+	cancelled.store(false);
+	parser.OnBefore = nullptr;
+	ABP_ASSERT_EQUAL(TrackingParser(config).Parse("1a2"), parser.ParsePipelined("1a2", 64));
+}
+
+ABP_TEST(Pipeline_EventsCantChangeLimits) {
+	ABParserToken<char>* tokens = MakeTokens({ "(", "a" });
+	SetTokenLimits(tokens[1], { "inner" });
+	tokens[0].SetEntersTokenLimit(std::string("inner"));
+
+	TestConfiguration config(tokens, 2);
+	PipelinedParser parser(config);
+	parser.OnBefore = [](TrackingParser& parser, const std::string&) { parser.ExitTokenLimit(); };
+
+	bool threw = false;
+	try {
+		parser.ParsePipelined("(a", 64);
+	} catch (const char*) {
+		threw = true;
+	}
+
+	ABP_ASSERT(threw);
+
+	// Without the pipeline, they can.
+	parser.OnBefore = [](TrackingParser& parser, const std::string& name) {
+		if (name == "(") parser.ExitTokenLimit();
+	};
+
+	ABP_ASSERT_EQUAL(Log({ "Before ( 0 []", "On ( [|]", "Before a 1 []", "On a [|]", "End []" }), parser.Parse("(a"));
+}
\ No newline at end of file
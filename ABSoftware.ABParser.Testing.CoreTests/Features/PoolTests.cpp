@@ -0,0 +1,90 @@
+#include "../CoreTests.h"
+#include "ABParserPool.h"
+#include <condition_variable>
+#include <memory>
+#include <thread>
+using namespace abparser;
+using namespace abparser_tests;
+
+ABP_TEST(Pool_ReusesReleasedParsers) {
+	TestConfiguration config({ "a", "bc" });
+	ABParserPool<char> pool(config);
+
+	ABParserBase<char>* parser = pool.Acquire();
+	Log first = ParseWithBase(*parser, "xaybcz");
+	pool.Release(parser);
+
+	ABParserBase<char>* reused = pool.Acquire();
+	ABP_ASSERT(reused == parser);
+	ABP_ASSERT_EQUAL(first, ParseWithBase(*reused, "xaybcz"));
+	pool.Release(reused);
+}
+
+ABP_TEST(Pool_ReleasedMidParse) {
+	TestConfiguration config({ "a", "bc" });
+	ABParserPool<char> pool(config);
+
+	ABParserBase<char>* parser = pool.Acquire();
+	parser->InitString((char*)"xaybcz", 6);
+	parser->ContinueExecution();
+	pool.Release(parser);
+
+	ABParserBase<char> fresh(config);
+	Log expected = ParseWithBase(fresh, "ybcz");
+
+	parser = pool.Acquire();
+	ABP_ASSERT_EQUAL(expected, ParseWithBase(*parser, "ybcz"));
+	pool.Release(parser);
+}
+
+ABP_TEST(Pool_DoesntShareParsersWithOtherPools) {
+	TestConfiguration config({ "a" });
+	ABParserPool<char> first(config);
+	ABParserPool<char> second(config);
+
+	ABParserBase<char>* parser = first.Acquire();
+	first.Release(parser);
+
+	ABParserBase<char>* fromSecond = second.Acquire();
+	ABP_ASSERT(fromSecond != parser);
+	second.Release(fromSecond);
+}
+
+ABP_TEST(Pool_DeletesParsersCachedByOtherThreads) {
+	TestConfiguration config({ "a" });
+
+	std::unique_ptr<ABParserPool<char>> pool(new ABParserPool<char>(config));
+
+	// The other thread is still alive when the pool goes, so its cache can't be what deletes the parser.
+	std::mutex lock;
+	std::condition_variable changed;
+	bool released = false, poolDeleted = false;
+
+	std::thread other([&]() {
+		ABParserBase<char>* parser = pool->Acquire();
+		ParseWithBase(*parser, "xay");
+		pool->Release(parser);
+
+		std::unique_lock<std::mutex> guard(lock);
+		released = true;
+		changed.notify_all();
+		changed.wait(guard, [&]() { return poolDeleted; });
+	});
+
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		changed.wait(guard, [&]() { return released; });
+	}
+
+	ABP_ASSERT(config->IsShared());
+	pool.reset();
+	ABP_ASSERT(!config->IsShared());
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		poolDeleted = true;
+		changed.notify_all();
+	}
+
+	other.join();
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// Only "," isn't subscribed to.
+class SkippingParser : public TrackingParser {
+public:
+	std::vector<std::string> Chunks;
+
+	SkippingParser(ABParserConfiguration<char>* configuration) : TrackingParser(configuration) {
+		Base.UnsubscribedTokens = ABParserUnsubscribedTokens::Skip;
+		Base.SetTokenSubscribed(1, false);
+	}
+
+	void OnTriviaChunk(const char* chunk, uint32_t chunkLength, ABParserTriviaChunkKind kind) override {
+		Chunks.push_back(std::string(chunk, chunkLength));
+	}
+};
+
+ABP_TEST(Subscription_SkipKeepsTriviaAround) {
+	TestConfiguration config({ "A", ",", "BCD" });
+	SkippingParser parser(config);
+
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|12y]", "Before BCD 6 [12y]", "On BCD [12y|34z]", "End [34z]" }), parser.Parse("xA1,2yBCD3,4z"));
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|12]", "Before BCD 6 [12]", "On BCD [12|z]", "End [z]" }), parser.Parse("xA1,,2BCD,,z,"));
+}
+
+ABP_TEST(Subscription_SkipUnderTriviaLimit) {
+	TestConfiguration config({ "A", ",", "BCD" });
+	config.AddTriviaLimit("noX", "x", false);
+
+	SkippingParser parser(config);
+	parser.OnBefore = [](TrackingParser& parser, const std::string& name) {
+		if (name == "A") parser.EnterTriviaLimit(std::string("noX"));
+	};
+
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|12y]", "Before BCD 8 [12y]", "On BCD [12y|3]", "End [3]" }), parser.Parse("xA1x,2xyBCD3,x"));
+}
+
+ABP_TEST(Subscription_SkipWithLongTrivia) {
+	TestConfiguration config({ "A", ",", "BCD" });
+	SkippingParser parser(config);
+	parser.Base.MaxTriviaLength = 2;
+
+	// Without a limit, it still can't be given straight from the text, as the skipped token would be in it.
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|]", "Before BCD 7 []", "On BCD [|]", "End []" }), parser.Parse("xA12,3yBCD,"));
+	ABP_ASSERT_EQUAL(Log({ "12", "3y" }), parser.Chunks);
+}
+
+ABP_TEST(Subscription_SkipNotPipelined) {
+	TestConfiguration config({ "A", ",", "BCD" });
+	SkippingParser parser(config);
+
+	parser.SetText("xA1,2yBCD3,4z");
+	ABP_ASSERT(!parser.StartPipelined());
+	ABP_ASSERT_EQUAL(Log({ "Before A 1 [x]", "On A [x|12y]", "Before BCD 6 [12y]", "On BCD [12y|34z]", "End [34z]" }), parser.Events);
+}
\ No newline at end of file
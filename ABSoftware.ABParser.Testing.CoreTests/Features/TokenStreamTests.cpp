@@ -0,0 +1,88 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// Reads a whole token stream back, in the same form as "DescribeResult" gives tokens (and the end), with the trivia taken from the text by its span.
+static Log ReadStream(const std::vector<uint8_t>& data, const std::string& text, const char* const* names) {
+	Log log;
+	ABParserTokenStreamReader reader(data.data(), data.size());
+
+	while (reader.Next())
+		log.push_back("Token " + std::string(names[reader.TokenIndex]) + " " + std::to_string(reader.TokenStart) + "+" + std::to_string(reader.TokenLength) + " [" + text.substr(reader.TriviaStart, reader.TriviaLength) + "]");
+
+	if (!reader.IsValid) log.push_back("Invalid");
+	else log.push_back("End [" + text.substr(reader.EndTriviaStart, reader.EndTriviaLength) + "]");
+
+	return log;
+}
+
+ABP_TEST(TokenStream_RoundTrip) {
+	const char* names[] = { "a", "bc", "bcd" };
+	TestConfiguration config({ "a", "bc", "bcd" });
+	std::string text = "xaybcdzbcw";
+
+	ABParserBase<char> parser(config);
+	parser.InitString((char*)text.data(), (uint32_t)text.size());
+
+	ABParserTokenStreamWriter writer;
+	ABP_ASSERT(writer.WriteParse(&parser));
+
+	ABP_ASSERT_EQUAL(Log({ "Token a 1+1 [x]", "Token bcd 3+3 [y]", "Token bc 7+2 [z]", "End [w]" }), ReadStream(writer.Data, text, names));
+}
+
+ABP_TEST(TokenStream_WriterReused) {
+	const char* names[] = { "a" };
+	TestConfiguration config({ "a" });
+
+	ABParserBase<char> parser(config);
+	ABParserTokenStreamWriter writer;
+
+	parser.InitString((char*)"1a2", 3);
+	ABP_ASSERT(writer.WriteParse(&parser));
+
+	parser.InitString((char*)"34a5", 4);
+	ABP_ASSERT(writer.WriteParse(&parser));
+
+	ABP_ASSERT_EQUAL(Log({ "Token a 2+1 [34]", "End [5]" }), ReadStream(writer.Data, "34a5", names));
+}
+
+ABP_TEST(TokenStream_WriterReusedAfterAbandoning) {
+	const char* names[] = { "a" };
+	TestConfiguration config({ "a" });
+	std::atomic<bool> cancelled(true);
+
+	ABParserBase<char> parser(config);
+	ABParserTokenStreamWriter writer;
+
+	parser.CancellationFlag = &cancelled;
+	parser.YieldCheckInterval = 1;
+	parser.InitString((char*)"1a2a3", 5);
+	ABP_ASSERT(!writer.WriteParse(&parser));
+
+	parser.CancellationFlag = nullptr;
+	parser.InitString((char*)"1a2", 3);
+	ABP_ASSERT(writer.WriteParse(&parser));
+
+	ABP_ASSERT_EQUAL(Log({ "Token a 1+1 [1]", "End [2]" }), ReadStream(writer.Data, "1a2", names));
+}
+
+ABP_TEST(TokenStream_ReplayMatchesRecording) {
+	TestConfiguration config({ "a", "bc" });
+	std::string text = "xaybcz";
+
+	TrackingParser parser(config);
+	parser.SetText(text);
+
+	ABParserTokenStreamWriter recorder;
+	ABP_ASSERT(parser.StartRecording(recorder));
+	Log recorded = parser.Events;
+
+	// Recording again into the same writer gives the same stream, not a second one after it.
+	std::vector<uint8_t> first = recorder.Data;
+	ABP_ASSERT(parser.StartRecording(recorder));
+	ABP_ASSERT(first == recorder.Data);
+
+	ABParserTokenStreamReader replay(recorder.Data.data(), recorder.Data.size());
+	parser.StartReplaying(replay);
+	ABP_ASSERT_EQUAL(recorded, parser.Events);
+}
\ No newline at end of file
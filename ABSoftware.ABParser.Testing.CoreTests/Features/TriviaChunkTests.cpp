@@ -0,0 +1,68 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+static const char* ChunkKindName(ABParserTriviaChunkKind kind) {
+	switch (kind) {
+	case ABParserTriviaChunkKind::Leading: return "Leading";
+	case ABParserTriviaChunkKind::Between: return "Between";
+	default: return "Trailing";
+	}
+}
+
+// Goes through the whole parse under the trivia limit "noX", logging the chunks as well as the events.
+class ChunkParser : public TrackingParser {
+public:
+	ChunkParser(ABParserConfiguration<char>* configuration) : TrackingParser(configuration) {}
+
+	void OnStart() override {
+		TrackingParser::OnStart();
+		Base.EnterTriviaLimit(std::string("noX"));
+	}
+
+	void OnTriviaChunk(const char* chunk, uint32_t chunkLength, ABParserTriviaChunkKind kind) override {
+		Events.push_back("Chunk " + std::string(ChunkKindName(kind)) + " [" + std::string(chunk, chunkLength) + "]");
+	}
+};
+
+ABP_TEST(TriviaChunk_SpansWithoutLimit) {
+	TestConfiguration config({ "," });
+	TrackingParser parser(config);
+	parser.Base.MaxTriviaLength = 3;
+
+	Log expected = TrackingParser(config).Parse("ab,cdefg,h");
+	ABP_ASSERT_EQUAL(expected, parser.Parse("ab,cdefg,h"));
+	ABP_ASSERT_EQUAL(3u, parser.Base.TriviaCapacity);
+}
+
+ABP_TEST(TriviaChunk_MaxTriviaLengthChangedBetweenTexts) {
+	TestConfiguration config({ "," });
+	TrackingParser parser(config);
+
+	parser.Parse("ab,cdefg,h");
+	ABP_ASSERT_EQUAL(10u, parser.Base.TriviaCapacity);
+
+	// The buffers are already big enough for this text, but the trivia buffer still shrinks.
+	parser.Base.MaxTriviaLength = 3;
+	Log limited = parser.Parse("ab,cdefg,h");
+	ABP_ASSERT_EQUAL(3u, parser.Base.TriviaCapacity);
+	ABP_ASSERT_EQUAL(TrackingParser(config).Parse("ab,cdefg,h"), limited);
+
+	parser.Base.MaxTriviaLength = 0;
+	parser.Parse("ab,cdefg,h");
+	ABP_ASSERT_EQUAL(10u, parser.Base.TriviaCapacity);
+}
+
+ABP_TEST(TriviaChunk_SaysWhichTrivia) {
+	TestConfiguration config({ "," });
+	config.AddTriviaLimit("noX", "x", false);
+
+	ChunkParser parser(config);
+	parser.Base.MaxTriviaLength = 3;
+
+	ABP_ASSERT_EQUAL(Log({
+		"Chunk Leading [abc]", "Chunk Leading [d]", "Before , 5 []",
+		"Chunk Between [ab]", "On , [|]", "Before , 10 []",
+		"Chunk Trailing [efg]", "Chunk Trailing [h]", "On , [|]", "End []"
+	}), parser.Parse("axbcd,axxb,exfgxh"));
+}
\ No newline at end of file
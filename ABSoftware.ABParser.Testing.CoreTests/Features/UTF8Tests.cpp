@@ -0,0 +1,80 @@
+#include "../CoreTests.h"
+using namespace abparser;
+using namespace abparser_tests;
+
+// "é" and "è" share their first byte, "→" is three bytes long.
+#define E_ACUTE "\xC3\xA9"
+#define E_GRAVE "\xC3\xA8"
+#define CAPITAL_E_ACUTE "\xC3\x89"
+#define ARROW "\xE2\x86\x92"
+
+ABP_TEST(UTF8_MultiByteTokens) {
+	TestConfiguration config({ E_ACUTE, ARROW, "b" }, true);
+	ABParserBase<char> parser(config);
+
+	// The positions are in bytes.
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token " E_ACUTE " 1+2 [a]", "Token " ARROW " 4+3 [ ]", "Token b 7+1 []", "End [c" E_GRAVE "]" }), ParseWithBase(parser, "a" E_ACUTE " " ARROW "bc" E_GRAVE));
+}
+
+ABP_TEST(UTF8_CodePointOffsets) {
+	TestConfiguration config({ "b" }, true);
+	ABParserBase<char> parser(config);
+
+	std::string text = "a" E_ACUTE ARROW "b";
+	ParseWithBase(parser, text);
+
+	ABP_ASSERT_EQUAL(0u, parser.GetCodePointOffset(0));
+	ABP_ASSERT_EQUAL(2u, parser.GetCodePointOffset(3));
+	ABP_ASSERT_EQUAL(3u, parser.GetCodePointOffset(6));
+
+	// Going backwards starts counting again.
+	ABP_ASSERT_EQUAL(1u, parser.GetCodePointOffset(1));
+}
+
+ABP_TEST(UTF8_BlacklistTriviaLimitKeepsWholeCharacters) {
+	ABParserToken<char>* tokens = MakeTokens({ "<", ">" });
+	tokens[0].SetEntersTriviaLimit("NoAcute");
+	tokens[1].SetExitsTriviaLimit("NoAcute");
+
+	TestConfiguration config(tokens, 2, true);
+	config.AddTriviaLimit("NoAcute", E_ACUTE, false);
+	ABParserBase<char> parser(config);
+
+	// Only the exact "é" sequence is taken out - "è" starts with the same byte, but all of it stays.
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token < 0+1 []", "Token > 7+1 [a" E_GRAVE "b]", "End [" E_ACUTE "]" }), ParseWithBase(parser, "<a" E_ACUTE E_GRAVE "b>" E_ACUTE));
+}
+
+ABP_TEST(UTF8_WhitelistTriviaLimitKeepsWholeCharacters) {
+	ABParserToken<char>* tokens = MakeTokens({ "<", ">" });
+	tokens[0].SetEntersTriviaLimit("OnlyArrows");
+	tokens[1].SetExitsTriviaLimit("OnlyArrows");
+
+	TestConfiguration config(tokens, 2, true);
+	config.AddTriviaLimit("OnlyArrows", ARROW "x", true);
+	ABParserBase<char> parser(config);
+
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token < 0+1 []", "Token > 10+1 [" ARROW "x]", "End []" }), ParseWithBase(parser, "<" E_ACUTE ARROW "xy" E_GRAVE ">"));
+}
+
+ABP_TEST(UTF8_DetectionLimitIgnoresWholeCharacters) {
+	ABParserToken<char>* tokens = MakeTokens({ "ab" });
+	tokens[0].DirectSetDetectionLimit((char*)E_ACUTE, 2);
+
+	TestConfiguration config(tokens, 1, true);
+	ABParserBase<char> parser(config);
+
+	// Both bytes of "é" are skipped over inside the token, but "è" (with the same first byte) isn't.
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token ab 0+4 []", "End [ a" E_GRAVE "b]" }), ParseWithBase(parser, "a" E_ACUTE "b a" E_GRAVE "b"));
+}
+
+ABP_TEST(UTF8_IgnoreCaseOnlyFoldsASCII) {
+	ABParserToken<char>* tokens = MakeTokens({ "abc", E_ACUTE });
+	tokens[0].SetIgnoreCase(true);
+	tokens[1].SetIgnoreCase(true);
+
+	TestConfiguration config(tokens, 2, true);
+	ABParserBase<char> parser(config);
+
+	// Multi-byte characters are never folded, so "É" doesn't match "é" - but nothing in them gets mistaken for an ASCII letter either.
+	ABP_ASSERT_EQUAL(Log({ "FirstUnlimited 0", "Token abc 2+3 [" CAPITAL_E_ACUTE "]", "Token " E_ACUTE " 5+2 []", "End []" }), ParseWithBase(parser, CAPITAL_E_ACUTE "AbC" E_ACUTE));
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Runs every core test (see "CoreTests.h"), and exits with how many failed.
+
+#include "CoreTests.h"
+#include <iostream>
+#include <cstring>
+
+int main(int argc, char** argv) {
+	// A name can be given to only run the tests that have it in their name.
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	int passed = 0, failed = 0;
+	for (const abparser_tests::TestCase& test : abparser_tests::GetTests()) {
+		if (filter && !strstr(test.Name, filter)) continue;
+
+		try {
+			test.Run();
+			passed++;
+		} catch (const abparser_tests::TestFailure& failure) {
+			std::cout << "FAILED " << test.Name << "\n  " << failure.Message << std::endl;
+			failed++;
+		} catch (const char* message) {
+			std::cout << "FAILED " << test.Name << "\n  Threw: " << message << std::endl;
+			failed++;
+		} catch (const std::exception& exception) {
+			std::cout << "FAILED " << test.Name << "\n  Threw: " << exception.what() << std::endl;
+			failed++;
+		}
+	}
+
+	std::cout << passed << " passed, " << failed << " failed" << std::endl;
+	return failed;
+}
\ No newline at end of file
@@ -53,7 +53,11 @@ public static void PerformanceTest()
             var tests = new Test[]
             {
                 new MultipleReuseTest(),
-                new MultipleStringSetsTest()
+                new MultipleStringSetsTest(),
+                new VerifyChainTest(1000, 16),
+                new VerifyChainTest(4000, 16),
+                new VerifyChainTest(1000, 64),
+                new VerifyChainTest(4000, 64)
             };
 
             for (int i = 0; i < tests.Length; i++)
@@ -0,0 +1,71 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.MemPerfTests.Tests
+{
+    /// <summary>
+    /// A test that parses a long run of "a"s with the tokens "a", "ab", "aab", "aaab"... up to "a" repeated "longestToken" times then "b" - every character here starts lots of tokens that all
+    /// contain each other, so the parser has to verify almost everything. Run it with different text lengths and compare, the time per character should stay the same no matter how long the
+    /// text is, and only grow with the longest token (as that's how many tokens can be in progress at once).
+    /// </summary>
+    public class VerifyChainTest : Test
+    {
+        VerifyChainParser _parser;
+        int _textLength;
+        int _longestToken;
+
+        protected override int NumberOfIterations => 100;
+        protected override string TestName => "VerifyChainTest (" + _textLength + " characters, tokens up to " + _longestToken + ")";
+
+        public VerifyChainTest(int textLength, int longestToken)
+        {
+            _textLength = textLength;
+            _longestToken = longestToken;
+        }
+
+        protected override void Prepare()
+        {
+            _parser = new VerifyChainParser(_longestToken);
+            _parser.SetText(new string('a', _textLength));
+        }
+
+        protected override void DoIteration(int i)
+        {
+            _parser.Start();
+        }
+
+        protected override void Finish()
+        {
+            _parser.Dispose();
+        }
+    }
+
+    public class VerifyChainParser : ABParser
+    {
+        static readonly Dictionary<int, ABParserConfiguration> ParserConfigs = new Dictionary<int, ABParserConfiguration>();
+
+        static ABParserConfiguration GetConfig(int longestToken)
+        {
+            if (!ParserConfigs.TryGetValue(longestToken, out ABParserConfiguration config))
+                ParserConfigs[longestToken] = config = new ABParserConfiguration(CreateTokens(longestToken));
+
+            return config;
+        }
+
+        static ABParserToken[] CreateTokens(int longestToken)
+        {
+            var tokens = new ABParserToken[longestToken + 1];
+            tokens[0] = new ABParserToken("a");
+
+            for (int i = 1; i <= longestToken; i++)
+                tokens[i] = new ABParserToken(new string('a', i) + "b");
+
+            return tokens;
+        }
+
+        public VerifyChainParser(int longestToken) : base(GetConfig(longestToken)) { }
+    }
+}
@@ -0,0 +1,45 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Exceptions;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class BatchTests
+    {
+        [TestMethod]
+        public void Batch_RecordsParsedSeparately()
+        {
+            var parser = new BatchParser();
+            parser.StartBatch("xAyBCDzAz", new int[] { 0, 7, 7, 9 });
+
+            CollectionAssert.AreEqual(new string[] { "Before A 1 x", "Before BCD 3 y", "Record 0 z", "Record 1 ", "Before A 0 ", "Record 2 z", "End " }, parser.Events);
+        }
+
+        [TestMethod]
+        public void Batch_MatchesSingleParse()
+        {
+            var parser = new BatchParser();
+            parser.StartBatch("xAyBCDz", new int[] { 0, 7 });
+            var batched = parser.Events.Take(2).ToArray();
+
+            parser.SetText("xAyBCDz");
+            parser.Start();
+
+            CollectionAssert.AreEqual(parser.Events.Take(2).ToArray(), batched);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ABParserInvalidBatchOffsets))]
+        public void Batch_OffsetsGoBackwards() => new BatchParser().StartBatch("xAyBCDz", new int[] { 0, 5, 3, 7 });
+
+        [TestMethod]
+        [ExpectedException(typeof(ABParserInvalidBatchOffsets))]
+        public void Batch_OffsetsPastEnd() => new BatchParser().StartBatch("xAyBCDz", new int[] { 0, 8 });
+    }
+}
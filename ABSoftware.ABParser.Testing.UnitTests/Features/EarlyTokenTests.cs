@@ -0,0 +1,24 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class EarlyTokenTests
+    {
+        [TestMethod]
+        public void TokensBeforeTrailing()
+        {
+            var parser = new EarlyTokensParser();
+            parser.SetText("xAyBCDz");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before A x", "On A", "Trailing A y", "Before BCD y", "On BCD", "Trailing BCD z" }, parser.Events);
+        }
+    }
+}
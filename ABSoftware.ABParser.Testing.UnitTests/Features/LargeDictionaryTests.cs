@@ -0,0 +1,34 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class LargeDictionaryTests
+    {
+        [TestMethod]
+        public void LargeDictionary_TokensPast16Bits()
+        {
+            var parser = new LargeDictionaryParser();
+            parser.SetText("a t69999 t00001 b");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before t69999 2 7", "Before t00001 9 14" }, parser.Events);
+        }
+
+        [TestMethod]
+        public void LargeDictionary_PositionsPast16Bits()
+        {
+            var parser = new LargeDictionaryParser();
+            parser.SetText(new string(' ', 70000) + "t65536");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before t65536 70000 70005" }, parser.Events);
+        }
+    }
+}
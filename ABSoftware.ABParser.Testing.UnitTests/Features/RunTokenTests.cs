@@ -0,0 +1,49 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using ABSoftware.ABParser.Exceptions;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class RunTokenTests
+    {
+        [TestMethod]
+        public void RunToken_WholeRunsAreTokens()
+        {
+            var parser = new RunTokenParser();
+            parser.SetText("abc+12 x");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before Identifier 0 2 ", "Before + 3 3 ", "Before Number 4 5 ", "Before Identifier 7 7  " }, parser.Events);
+        }
+
+        [TestMethod]
+        public void RunToken_TakesPriorityOverTokensStartingThere()
+        {
+            var parser = new RunTokenParser();
+            parser.SetText("in inner");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before Identifier 0 1 ", "Before Identifier 3 7  " }, parser.Events);
+        }
+
+        [TestMethod]
+        public void RunToken_SplitAtMaxLength()
+        {
+            var parser = new RunTokenParser();
+            parser.SetText("+123456");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before + 0 0 ", "Before Number 1 4 ", "Before Number 5 6 " }, parser.Events);
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ABParserInvalidRun))]
+        public void RunToken_UnpairedRanges() => new ABParserToken("Bad", "").SetRun(1, 0, 'a', 'z', '0');
+    }
+}
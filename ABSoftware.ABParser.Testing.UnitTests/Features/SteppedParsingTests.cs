@@ -0,0 +1,83 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class SteppedParsingTests : UnitTestBase
+    {
+        const string Text = "AtheBtheyCtheyarDtheyareE";
+
+        static TrackingParser RunStepped(string text, int characterBudget = 0)
+        {
+            var parser = new TheyParser() { CharacterBudget = characterBudget };
+            parser.SetText(text);
+            parser.BeginParse();
+
+            while (parser.ContinueParse()) ;
+            return parser;
+        }
+
+        static TrackingParser RunWithBetweenEvents(string text)
+        {
+            var parser = new TheyParser();
+            parser.SetText(text);
+            parser.StartAsync(() => Task.Delay(1)).Wait();
+            return parser;
+        }
+
+        [TestMethod]
+        [DataRow(new string[] { "A", "B", "C", "arD", "E" }, "Trivia")]
+        [DataRow(new string[] { "the", "they", "they", "theyare" }, "Tokens")]
+        [DataRow(new int[] { 1, 5, 10, 17 }, "TokenStarts")]
+        [DataRow(new int[] { 3, 8, 13, 23 }, "TokenEnds")]
+        public void ContinueParse(object expected, string toTest) => RunStepped(Text).Test(toTest, expected);
+
+        [TestMethod]
+        [DataRow(new string[] { "A", "B", "C", "arD", "E" }, "Trivia")]
+        [DataRow(new string[] { "the", "they", "they", "theyare" }, "Tokens")]
+        [DataRow(new int[] { 1, 5, 10, 17 }, "TokenStarts")]
+        [DataRow(new int[] { 3, 8, 13, 23 }, "TokenEnds")]
+        public void StartAsyncBetweenEvents(object expected, string toTest) => RunWithBetweenEvents(Text).Test(toTest, expected);
+
+        [TestMethod]
+        [DataRow(new string[] { "A", "B", "C", "arD", "E" }, "Trivia")]
+        [DataRow(new string[] { "the", "they", "they", "theyare" }, "Tokens")]
+        [DataRow(new int[] { 1, 5, 10, 17 }, "TokenStarts")]
+        [DataRow(new int[] { 3, 8, 13, 23 }, "TokenEnds")]
+        public void ContinueParseWithCharacterBudget(object expected, string toTest) => RunStepped(Text, 1).Test(toTest, expected);
+
+        [TestMethod]
+        public void StartAsyncCancelled()
+        {
+            var parser = new TheyParser() { CharacterBudget = 1 };
+            parser.SetText(Text);
+
+            var cancellation = new CancellationTokenSource();
+            cancellation.Cancel();
+
+            // (This might come through as a "TaskCanceledException", which is still one of these)
+            bool cancelled = false;
+            try { parser.StartAsync(cancellation.Token).GetAwaiter().GetResult(); }
+            catch (OperationCanceledException) { cancelled = true; }
+
+            Assert.IsTrue(cancelled);
+
+            // It can still be used again afterwards.
+            parser.Start();
+            parser.Test("Tokens", new string[] { "the", "they", "they", "theyare" });
+        }
+
+        [TestMethod]
+        public void ContinueParseAfterFinished()
+        {
+            var parser = RunStepped(Text);
+            Assert.IsFalse(parser.ContinueParse());
+        }
+    }
+}
@@ -0,0 +1,44 @@
+﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Testing.UnitTests.Parsers;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Features
+{
+    [TestClass]
+    public class SubscriptionTests
+    {
+        [TestMethod]
+        public void Unsubscribed_AsTrivia()
+        {
+            var parser = new SubscribedTokensParser(ABParserUnsubscribedTokens.AsTrivia);
+            parser.SetText("xA,yBCD,z");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before A x", "Before BCD ,y", "End ,z" }, parser.Events);
+        }
+
+        [TestMethod]
+        public void Unsubscribed_Skip()
+        {
+            var parser = new SubscribedTokensParser(ABParserUnsubscribedTokens.Skip);
+            parser.SetText("xA,yBCD,z");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before A x", "Before BCD y", "End z" }, parser.Events);
+        }
+
+        [TestMethod]
+        public void Unsubscribed_Skip_KeepsTriviaAround()
+        {
+            var parser = new SubscribedTokensParser(ABParserUnsubscribedTokens.Skip);
+            parser.SetText("xA1,2yBCD3,4z");
+            parser.Start();
+
+            CollectionAssert.AreEqual(new string[] { "Before A x", "Before BCD 12y", "End 34z" }, parser.Events);
+        }
+    }
+}
@@ -17,6 +17,13 @@ public class TokenLimitTests : UnitTestBase
         [DataRow(new int[] { 1, 6, 7 }, "TokenEnds")]
         public void OneLevel_SingleStart_SingleEnd(object expected, string toTest) => RunQuoteLimit("A\"aBdc\"B").Test(toTest, expected);
 
+        [TestMethod]
+        [DataRow(new string[] { "A", "aBdc", "", "", "a\"B\"", "", "" }, "Trivia")]
+        [DataRow(new string[] { "DOUBLE_QUOTE", "DOUBLE_QUOTE", "CAPITAL_B", "SINGLE_QUOTE", "SINGLE_QUOTE", "CAPITAL_B" }, "Tokens")]
+        [DataRow(new int[] { 1, 6, 7, 8, 13, 14 }, "TokenStarts")]
+        [DataRow(new int[] { 1, 6, 7, 8, 13, 14 }, "TokenEnds")]
+        public void OneLevel_LimitRules(object expected, string toTest) => RunQuoteLimitRules("A\"aBdc\"B'a\"B\"'B").Test(toTest, expected);
+
         [TestMethod]
         [DataRow(new string[] { "A!", "abc", "d", "", "deep", "est", "out", "", "g", "", " ", "?", "B" }, "Trivia")]
         [DataRow(new string[] { "<", "<<", "?", "<<<", "?", ">", ">>", "<<", "<<<", "!", "<", ">" }, "Tokens")]
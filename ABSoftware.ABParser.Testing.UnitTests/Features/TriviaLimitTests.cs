@@ -1,4 +1,5 @@
 ﻿using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ABSoftware.ABParser.Exceptions;
 using System;
 using System.Collections.Generic;
 using System.Linq;
@@ -30,5 +31,15 @@ public class TriviaLimitTests : UnitTestBase
         [DataRow(new int[] { 2, 8 }, "TokenStarts")]
         [DataRow(new int[] { 2, 8 }, "TokenEnds")]
         public void Whitelist(object expected, string toTest) => RunWhitelistTriviaLimit("h AcjbkaCl o").Test(toTest, expected);
+
+        [TestMethod]
+        public void AddedAfterParserMade()
+        {
+            var config = new ABParserConfiguration(new ABParserToken[] { new ABParserToken("A") }, 1);
+            var parser = new TrackingParser(config);
+
+            Assert.ThrowsException<ABParserConfigurationInUse>(() => config.AddTriviaLimit(false, "NoWhiteSpace", ' '));
+            parser.Dispose();
+        }
     }
 }
\ No newline at end of file
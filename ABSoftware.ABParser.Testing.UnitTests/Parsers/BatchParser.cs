@@ -0,0 +1,30 @@
+﻿using ABSoftware.ABParser.Events;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // Records the tokens it's given, and where each record ends.
+    public class BatchParser : ABParser
+    {
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(new ABParserToken[] {
+            new ABParserToken("A"),
+            new ABParserToken("BCD")
+        });
+
+        public List<string> Events = new List<string>();
+
+        public BatchParser() : base(ParserConfig) { }
+
+        protected override void OnStart() => Events.Clear();
+
+        protected override void BeforeTokenProcessed(BeforeTokenProcessedEventArgs args) => Events.Add("Before " + args.CurrentToken.Token.Name + " " + args.CurrentToken.Start + " " + args.GetLeadingAsString());
+
+        protected override void OnRecordEnd(OnEndEventArgs args) => Events.Add("Record " + CurrentRecord + " " + args.GetLeadingAsString());
+
+        protected override void OnEnd(OnEndEventArgs args) => Events.Add("End " + args.GetLeadingAsString());
+    }
+}
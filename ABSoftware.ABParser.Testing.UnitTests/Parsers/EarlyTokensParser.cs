@@ -0,0 +1,30 @@
+﻿using ABSoftware.ABParser.Events;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // Records the order the events come in, when the tokens are given early.
+    public class EarlyTokensParser : ABParser
+    {
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(new ABParserToken[] {
+            new ABParserToken("A"),
+            new ABParserToken("BCD")
+        });
+
+        public List<string> Events = new List<string>();
+
+        public EarlyTokensParser() : base(ParserConfig) => EmitTokensEarly = true;
+
+        protected override void OnStart() => Events.Clear();
+
+        protected override void BeforeTokenProcessed(BeforeTokenProcessedEventArgs args) => Events.Add("Before " + args.CurrentToken.Token.Name + " " + args.GetLeadingAsString());
+
+        protected override void OnTokenProcessed(OnTokenProcessedEventArgs args) => Events.Add("On " + args.CurrentToken.Token.Name + (args.TrailingKnown ? " Known" : ""));
+
+        protected override void OnTrailingProcessed(OnTokenProcessedEventArgs args) => Events.Add("Trailing " + args.CurrentToken.Token.Name + " " + args.GetTrailingAsString());
+    }
+}
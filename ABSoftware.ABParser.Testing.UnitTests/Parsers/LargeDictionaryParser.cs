@@ -0,0 +1,25 @@
+﻿using ABSoftware.ABParser.Events;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // Has more tokens than fit in 16 bits - "t00000" up to "t69999".
+    public class LargeDictionaryParser : ABParser
+    {
+        public const int NumberOfTokens = 70000;
+
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(Enumerable.Range(0, NumberOfTokens).Select(i => new ABParserToken("t" + i.ToString("D5"))).ToArray());
+
+        public List<string> Events = new List<string>();
+
+        public LargeDictionaryParser() : base(ParserConfig) { }
+
+        protected override void OnStart() => Events.Clear();
+
+        protected override void BeforeTokenProcessed(BeforeTokenProcessedEventArgs args) => Events.Add("Before " + args.CurrentToken.Token.Name + " " + args.CurrentToken.Start + " " + args.CurrentToken.End);
+    }
+}
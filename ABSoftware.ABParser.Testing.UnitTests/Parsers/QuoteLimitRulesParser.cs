@@ -0,0 +1,20 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // The same as "QuoteLimitParser", but with the quotes entering and exiting their limits by themselves.
+    public class QuoteLimitRulesParser : TrackingParser
+    {
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(new ABParserToken[] {
+            new ABParserToken("DOUBLE_QUOTE", "\"").SetLimits("DoubleStringLimit").SetEntersTokenLimit("DoubleStringLimit").SetExitsTokenLimit("DoubleStringLimit"),
+            new ABParserToken("SINGLE_QUOTE", "'").SetLimits("SingleStringLimit").SetEntersTokenLimit("SingleStringLimit").SetExitsTokenLimit("SingleStringLimit"),
+            new ABParserToken("CAPITAL_B", "B"),
+        });
+
+        public QuoteLimitRulesParser() : base(ParserConfig) { }
+    }
+}
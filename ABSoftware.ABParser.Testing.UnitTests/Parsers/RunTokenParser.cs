@@ -0,0 +1,28 @@
+﻿using ABSoftware.ABParser.Events;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // Identifiers and numbers come through as run tokens, alongside some normal tokens (one of which, "in", could also be an identifier).
+    public class RunTokenParser : ABParser
+    {
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(new ABParserToken[] {
+            new ABParserToken("Identifier", "").SetRun(1, 0, 'a', 'z', 'A', 'Z', '_', '_'),
+            new ABParserToken("Number", "").SetRun(1, 4, '0', '9'),
+            new ABParserToken("+"),
+            new ABParserToken("in")
+        });
+
+        public List<string> Events = new List<string>();
+
+        public RunTokenParser() : base(ParserConfig) { }
+
+        protected override void OnStart() => Events.Clear();
+
+        protected override void BeforeTokenProcessed(BeforeTokenProcessedEventArgs args) => Events.Add("Before " + args.CurrentToken.Token.Name + " " + args.CurrentToken.Start + " " + args.CurrentToken.End + " " + args.GetLeadingAsString());
+    }
+}
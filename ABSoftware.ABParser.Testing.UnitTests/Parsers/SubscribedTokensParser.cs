@@ -0,0 +1,33 @@
+﻿using ABSoftware.ABParser.Events;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Testing.UnitTests.Parsers
+{
+    // Records the tokens it's given, when it isn't subscribed to the commas.
+    public class SubscribedTokensParser : ABParser
+    {
+        static readonly ABParserConfiguration ParserConfig = new ABParserConfiguration(new ABParserToken[] {
+            new ABParserToken("A"),
+            new ABParserToken("BCD"),
+            new ABParserToken(",")
+        });
+
+        public List<string> Events = new List<string>();
+
+        public SubscribedTokensParser(ABParserUnsubscribedTokens unsubscribedTokens) : base(ParserConfig)
+        {
+            UnsubscribedTokens = unsubscribedTokens;
+            SetTokenSubscribed(2, false);
+        }
+
+        protected override void OnStart() => Events.Clear();
+
+        protected override void BeforeTokenProcessed(BeforeTokenProcessedEventArgs args) => Events.Add("Before " + args.CurrentToken.Token.Name + " " + args.GetLeadingAsString());
+
+        protected override void OnEnd(OnEndEventArgs args) => Events.Add("End " + args.GetLeadingAsString());
+    }
+}
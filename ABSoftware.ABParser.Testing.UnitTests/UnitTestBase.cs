@@ -29,6 +29,7 @@ T InitializeAndRunParser<T>(ref T parser, string text)
         static TheyWithLongTokenParser RunTheyWithLongTokenParser;
         static ImpossibleVerifyParser RunImpossibleVerifyParser;
         static QuoteLimitParser RunQuoteLimitParser;
+        static QuoteLimitRulesParser RunQuoteLimitRulesParser;
         static AngledLimitParser RunAngledLimitParser;
         static WhitelistTriviaLimitParser RunWhitelistTriviaLimitParser;
         static BlacklistTriviaLimitParser RunBlacklistTriviaLimitParser;
@@ -42,6 +43,7 @@ T InitializeAndRunParser<T>(ref T parser, string text)
         public TheyWithLongTokenParser RunTheyWithLongToken(string text) => InitializeAndRunParser(ref RunTheyWithLongTokenParser, text);
         public ImpossibleVerifyParser RunImpossibleVerify(string text) => InitializeAndRunParser(ref RunImpossibleVerifyParser, text);
         public QuoteLimitParser RunQuoteLimit(string text) => InitializeAndRunParser(ref RunQuoteLimitParser, text);
+        public QuoteLimitRulesParser RunQuoteLimitRules(string text) => InitializeAndRunParser(ref RunQuoteLimitRulesParser, text);
         public AngledLimitParser RunAngledLimit(string text) => InitializeAndRunParser(ref RunAngledLimitParser, text);
         public WhitelistTriviaLimitParser RunWhitelistTriviaLimit(string text) => InitializeAndRunParser(ref RunWhitelistTriviaLimitParser, text);
         public BlacklistTriviaLimitParser RunBlacklistTriviaLimit(string text) => InitializeAndRunParser(ref RunBlacklistTriviaLimitParser, text);
@@ -4,6 +4,7 @@
 using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
 
 namespace ABSoftware.ABParser
@@ -21,11 +22,33 @@ public abstract class ABParser : IDisposable
         string _textAsString;
         public char[] Text;
         public int TextLength;
+
+        /// <summary>
+        /// Which record of the batch is being parsed, when using <see cref="StartBatch(string, int[])"/>.
+        /// </summary>
+        public int CurrentRecord;
         public ABParserToken[] Tokens;
 
         public Stack<string> CurrentEventTokenLimits = new Stack<string>();
         public Stack<string> CurrentTriviaLimits = new Stack<string>();
 
+        /// <summary>
+        /// If this is set, <see cref="OnTokenProcessed"/> is triggered for every token as soon as it's found (straight after its <see cref="BeforeTokenProcessed"/>), rather than waiting for the next token
+        /// to be found so it can have its trailing. The trailing is given afterwards instead, in <see cref="OnTrailingProcessed"/>, once it's known.
+        /// </summary>
+        public bool EmitTokensEarly;
+
+        /// <summary>
+        /// What happens to the text of any tokens this parser isn't subscribed to - see <see cref="SetTokenSubscribed(int, bool)"/>.
+        /// </summary>
+        public ABParserUnsubscribedTokens UnsubscribedTokens;
+
+        /// <summary>
+        /// If this is set, the core gives control back after going through this many characters without an event, so a long stretch without any tokens can't hold up cancellation,
+        /// or <see cref="ContinueParse"/> for too long. It's only given to the core when a parse starts.
+        /// </summary>
+        public int CharacterBudget;
+
         #endregion
 
         #region Internal Data
@@ -40,6 +63,7 @@ public abstract class ABParser : IDisposable
 
         BeforeTokenProcessedEventArgs BeforeTokenProcessedArgs;
         OnTokenProcessedEventArgs OnTokenProcessedArgs;
+        OnTokenProcessedEventArgs EarlyOnTokenProcessedArgs;
         OnEndEventArgs OnEndArgs;
         int OFUCPPos;
 
@@ -50,7 +74,20 @@ public abstract class ABParser : IDisposable
         bool _disposedForNextParse = false;
         bool _disposeAtDestruction = false;
         bool _disposeAsyncronously = true;
-        bool _currentlyDisposing = false;
+
+        // Anything that needs the native parser waits on this, rather than checking every so often whether it's still disposing.
+        static readonly Task CompletedTask = Task.FromResult(0);
+        Task _disposeTask = CompletedTask;
+
+        // Where the current parse has got up to, and the buffer the core puts each result's data into (kept between parses, and only made bigger when the text is).
+        ContinueExecutionResult _executionResult = ContinueExecutionResult.StopAndFinalOnTokenProcessed;
+        ushort[] _resultData;
+
+        // Which tokens are subscribed to, one bit for each (null when they all are). These are only given to the core when a parse starts.
+        ulong[] _subscribedTokens;
+
+        // Where each record starts in the text, while a batch is being parsed (null otherwise).
+        int[] _batchOffsets;
 
         #endregion
 
@@ -66,6 +103,7 @@ internal void InitializeABParser(ABParserConfiguration config)
 
             BeforeTokenProcessedArgs = new BeforeTokenProcessedEventArgs(this);
             OnTokenProcessedArgs = new OnTokenProcessedEventArgs(this);
+            EarlyOnTokenProcessedArgs = new OnTokenProcessedEventArgs(this) { TrailingKnown = false, Trailing = new char[0] };
             OnEndArgs = new OnEndEventArgs();
             OFUCPPos = 0;
 
@@ -81,6 +119,10 @@ internal void InitString(string text)
             _textAsString = text;
             Text = text.ToCharArray();
             TextLength = text.Length;
+
+            if (_resultData == null || _resultData.Length < TextLength + 8)
+                _resultData = new ushort[TextLength + 8];
+
             NativeMethods.InitString(_baseParser, text, TextLength);
         }
 
@@ -90,26 +132,21 @@ internal void ResetInfo()
             EncounteredSecondToken = false;
         }
 
-        internal async void DisposeDataForNextParse()
+        internal void DisposeDataForNextParse()
         {
             if (_disposedForNextParse)
                 return;
             _disposedForNextParse = true;
             if (_disposeAsyncronously)
             {
-                if (_currentlyDisposing) 
+                if (!_disposeTask.IsCompleted)
                     return;
-                _currentlyDisposing = true;
 
-                await Task.Run(() =>
-                {
-                    NativeMethods.DisposeDataForNextParse(_baseParser);
-                    _currentlyDisposing = false;
-                });
+                _disposeTask = Task.Run(() => NativeMethods.DisposeDataForNextParse(_baseParser));
             } else NativeMethods.DisposeDataForNextParse(_baseParser);
         }
 
-        internal unsafe int TwoShortsToInteger(ushort* data, int index) => (data[index] >> 16) + data[index + 1];
+        internal unsafe int TwoShortsToInteger(ushort* data, int index) => (data[index] << 16) + data[index + 1];
 
         internal unsafe void ShortsToString(ushort* data, int index, out char[] text)
         {
@@ -131,6 +168,7 @@ unsafe void HandleResult(ContinueExecutionResult result, ushort* data)
                     OFUCPPos = TwoShortsToInteger(data, 0);
                     return;
                 case ContinueExecutionResult.None:
+                case ContinueExecutionResult.Yielded:
                     return;
             }
 
@@ -138,7 +176,7 @@ unsafe void HandleResult(ContinueExecutionResult result, ushort* data)
             MoveTokenInfos();
 
             // Get the trivia, which is always transmitted for everything.
-            ShortsToString(data, 5, out var trivia);
+            ShortsToString(data, 6, out var trivia);
 
             // Handle BeforeTokenProcessedArgs
             switch (result)
@@ -206,16 +244,16 @@ unsafe void ResetTriviaStringCaches()
 
         unsafe void UpdateCurrentEventTokenInfo(ushort* data)
         {
-            CurrentEventTokenInfo.Token = Tokens[data[0]];
-            CurrentEventTokenInfo.Start = TwoShortsToInteger(data, 1);
-            CurrentEventTokenInfo.End = TwoShortsToInteger(data, 3);
+            CurrentEventTokenInfo.Token = Tokens[TwoShortsToInteger(data, 0)];
+            CurrentEventTokenInfo.Start = TwoShortsToInteger(data, 2);
+            CurrentEventTokenInfo.End = TwoShortsToInteger(data, 4);
         }
 
         #endregion
 
         #region Main Execution
 
-        internal async Task Execute()
+        internal async Task Execute(Func<Task> betweenEvents = null, CancellationToken cancellationToken = default(CancellationToken))
         {
             // Don't do anything if there isn't any text to parse.
             if (TextLength == 0)
@@ -226,63 +264,155 @@ internal async Task Execute()
             }
 
             // If we're currently disposing, then wait until we're done before moving on.
-            while (_currentlyDisposing)
-                await Task.Delay(1);
+            await _disposeTask.ConfigureAwait(false);
 
-            DoExecute();
+            BeginExecution();
+            while (ExecuteNext())
+            {
+                if (cancellationToken.IsCancellationRequested)
+                {
+                    AbandonParse();
+                    cancellationToken.ThrowIfCancellationRequested();
+                }
+
+                if (betweenEvents != null)
+                    await betweenEvents().ConfigureAwait(false);
+            }
         }
 
-        unsafe void DoExecute()
+        unsafe void BeginExecution()
         {
-            ushort* data = stackalloc ushort[TextLength + 8];
-
             // Trigger the "OnStart".
             OnStart();
+            _executionResult = ContinueExecutionResult.None;
+
+            fixed (ulong* mask = _subscribedTokens)
+                NativeMethods.SetTokenSubscriptions(_baseParser, mask, _subscribedTokens == null ? 0 : (uint)_subscribedTokens.Length, UnsubscribedTokens);
+
+            NativeMethods.SetCharacterBudget(_baseParser, (uint)CharacterBudget);
+        }
+
+        // This is how execution works on this side.
+        // Quite simply, we will run "ContinueExecution", and that will do all of the work in C++.
+        // Then, whenever the C++ code wants us to do something - like calling "OnTokenProcessed", it will return a result, and we will act on that.
+        // After we've done that, we'll then just get it to continue execution - each call to this handles one result, and gives false once we've hit the "Stop" result.
+        unsafe bool ExecuteNext()
+        {
+            if (_executionResult == ContinueExecutionResult.StopAndFinalOnTokenProcessed)
+                return false;
 
-            // This is how execution works on this side.
-            // Quite simply, we will run "ContinueExecution", and that will do all of the work in C++.
-            // Then, whenever the C++ code wants us to do something - like calling "OnTokenProcessed", it will return a result, and we will act on that.
-            // After we've done that, we'll then just get it to continue execution.
             var result = ContinueExecutionResult.None;
 
-            // Just keep on executing until we hit the "Stop" result.
-            while (result != ContinueExecutionResult.StopAndFinalOnTokenProcessed)
+            fixed (ushort* data = _resultData)
+                HandleResult(result = _executionResult = _batchOffsets == null ? NativeMethods.ContinueExecution(_baseParser, data) : NativeMethods.ContinueBatchExecution(_baseParser, data), data);
+
+            // Do whatever the result said to do.
+            switch (result)
             {
-                HandleResult(result = NativeMethods.ContinueExecution(_baseParser, data), data);
+                case ContinueExecutionResult.StopAndFinalOnTokenProcessed:
 
-                // Do whatever the result said to do.
-                switch (result)
-                {
-                    case ContinueExecutionResult.StopAndFinalOnTokenProcessed:
+                    if (EncounteredToken)
+                        TriggerOnTokenProcessed();
 
-                        if (!EncounteredToken)
-                            break;
+                    // In a batch, this is only the end of one record - the core moves onto the next one by itself.
+                    if (_batchOffsets != null)
+                    {
+                        FinishRecord();
+                        if (++CurrentRecord < _batchOffsets.Length - 1)
+                        {
+                            _executionResult = ContinueExecutionResult.None;
+                            return true;
+                        }
 
-                        OnTokenProcessed(OnTokenProcessedArgs);
-                        break;
+                        FinishExecution(new char[0]);
+                        return false;
+                    }
 
-                    case ContinueExecutionResult.FirstBeforeTokenProcessed:
+                    FinishExecution(EncounteredToken ? OnTokenProcessedArgs.Trailing : Text);
+                    return false;
 
-                        EncounteredToken = true;
-                        BeforeTokenProcessed(BeforeTokenProcessedArgs);
+                case ContinueExecutionResult.FirstBeforeTokenProcessed:
 
-                        break;
-                    case ContinueExecutionResult.OnThenBeforeTokenProcessed:
+                    EncounteredToken = true;
+                    ApplyLimitRules(CurrentEventTokenInfo.Token);
+                    BeforeTokenProcessed(BeforeTokenProcessedArgs);
+                    if (EmitTokensEarly) TriggerEarlyOnTokenProcessed();
 
-                        EncounteredSecondToken = true;
+                    break;
+                case ContinueExecutionResult.OnThenBeforeTokenProcessed:
 
-                        OnTokenProcessed(OnTokenProcessedArgs);
-                        BeforeTokenProcessed(BeforeTokenProcessedArgs);
+                    EncounteredSecondToken = true;
 
-                        break;
-                    case ContinueExecutionResult.OnFirstUnlimitedCharacterProcessed:
+                    TriggerOnTokenProcessed();
+                    ApplyLimitRules(CurrentEventTokenInfo.Token);
+                    BeforeTokenProcessed(BeforeTokenProcessedArgs);
+                    if (EmitTokensEarly) TriggerEarlyOnTokenProcessed();
 
-                        OnFirstUnlimitedCharacterProcessed(OFUCPPos);
-                        break;
-                }
+                    break;
+                case ContinueExecutionResult.OnFirstUnlimitedCharacterProcessed:
+
+                    OnFirstUnlimitedCharacterProcessed(OFUCPPos);
+                    break;
+
+                // The core ran out of its character budget - there's nothing to do, it just needs continuing again.
+                case ContinueExecutionResult.Yielded:
+                    break;
             }
 
-            OnEndArgs.Leading = EncounteredToken ? OnTokenProcessedArgs.Trailing : Text;
+            return true;
+        }
+
+        void TriggerOnTokenProcessed()
+        {
+            if (EmitTokensEarly) OnTrailingProcessed(OnTokenProcessedArgs);
+            else OnTokenProcessed(OnTokenProcessedArgs);
+        }
+
+        // When giving tokens early, this is everything "OnTokenProcessed" can have before the next token is found - which is just what "BeforeTokenProcessed" had.
+        void TriggerEarlyOnTokenProcessed()
+        {
+            EarlyOnTokenProcessedArgs.PreviousToken = BeforeTokenProcessedArgs.PreviousToken;
+            EarlyOnTokenProcessedArgs.CurrentToken = BeforeTokenProcessedArgs.CurrentToken;
+            EarlyOnTokenProcessedArgs.Leading = BeforeTokenProcessedArgs.Leading;
+            EarlyOnTokenProcessedArgs.LeadingAsString = null;
+
+            OnTokenProcessed(EarlyOnTokenProcessedArgs);
+        }
+
+        // The core has already entered or exited any limits the token's rules say to, so this just keeps track of them on this side too.
+        void ApplyLimitRules(ABParserToken token)
+        {
+            if (!token.HasLimitRules) return;
+
+            if (token.ExitsTokenLimit != null && CurrentEventTokenLimits.Count > 0 && CurrentEventTokenLimits.Peek() == token.ExitsTokenLimit) CurrentEventTokenLimits.Pop();
+            else if (token.EntersTokenLimit != null) CurrentEventTokenLimits.Push(token.EntersTokenLimit);
+
+            if (token.ExitsTriviaLimit != null && CurrentTriviaLimits.Count > 0 && CurrentTriviaLimits.Peek() == token.ExitsTriviaLimit) CurrentTriviaLimits.Pop();
+            else if (token.EntersTriviaLimit != null) CurrentTriviaLimits.Push(token.EntersTriviaLimit);
+        }
+
+        void FinishRecord()
+        {
+            if (EncounteredToken)
+                OnEndArgs.Leading = OnTokenProcessedArgs.Trailing;
+            else
+            {
+                OnEndArgs.Leading = new char[_batchOffsets[CurrentRecord + 1] - _batchOffsets[CurrentRecord]];
+                Array.Copy(Text, _batchOffsets[CurrentRecord], OnEndArgs.Leading, 0, OnEndArgs.Leading.Length);
+            }
+
+            OnEndArgs.LeadingAsString = null;
+            OnRecordEnd(OnEndArgs);
+
+            ResetInfo();
+            CurrentEventTokenLimits.Clear();
+            CurrentTriviaLimits.Clear();
+        }
+
+        void FinishExecution(char[] leading)
+        {
+            OnEndArgs.Leading = leading;
+            OnEndArgs.LeadingAsString = null;
 
             OnEnd(OnEndArgs);
             CurrentEventTokenLimits.Clear();
@@ -308,6 +438,11 @@ unsafe void DoExecute()
         /// </summary>
         protected virtual void OnEnd(OnEndEventArgs args) { }
 
+        /// <summary>
+        /// Called when we finish each record in a batch (see <see cref="StartBatch(string, int[])"/>), with everything after its last token. <see cref="CurrentRecord"/> says which one it was.
+        /// </summary>
+        protected virtual void OnRecordEnd(OnEndEventArgs args) { }
+
         /// <summary>
         /// Called when we encounter the very first unlimited character in the document. Used to initialize data only when there's something in the document.
         /// </summary>
@@ -323,30 +458,131 @@ unsafe void DoExecute()
         /// </summary>
         protected virtual void OnTokenProcessed(OnTokenProcessedEventArgs args) { }
 
+        /// <summary>
+        /// Only used when <see cref="EmitTokensEarly"/> is set - called once a token's trailing is known, with everything <see cref="OnTokenProcessed"/> would normally have been given.
+        /// </summary>
+        protected virtual void OnTrailingProcessed(OnTokenProcessedEventArgs args) { }
+
         #endregion
 
         #region Public Methods
 
         public void SetText(string text) => SetTextAsync(text).Wait();
 
-        public Task SetTextAsync(string text)
+        public async Task SetTextAsync(string text)
         {
-            return Task.Run(async () =>
-            {
-                while (_currentlyDisposing)
-                    await Task.Delay(1);
-                InitString(text);
-            });
+            await _disposeTask.ConfigureAwait(false);
+            InitString(text);
         }
 
         public void Start() => StartAsync().Wait();
 
-        public async Task StartAsync()
+        public Task StartAsync() => StartAsync(null);
+
+        public Task StartAsync(CancellationToken cancellationToken) => StartAsync(null, cancellationToken);
+
+        /// <summary>
+        /// Runs the parse, awaiting <paramref name="betweenEvents"/> after every event. This means the parse can be held up (without blocking a thread) while whatever the events are feeding into catches up.
+        /// </summary>
+        public Task StartAsync(Func<Task> betweenEvents) => StartAsync(betweenEvents, CancellationToken.None);
+
+        /// <summary>
+        /// The same, but if <paramref name="cancellationToken"/> gets cancelled, the parse is abandoned after the next event (or the next time the core yields, if <see cref="CharacterBudget"/> is set), without <see cref="OnEnd"/>.
+        /// A deadline can be set with <see cref="CancellationTokenSource.CancelAfter(TimeSpan)"/>.
+        /// </summary>
+        public async Task StartAsync(Func<Task> betweenEvents, CancellationToken cancellationToken)
         {
             if (Text == null)
                 throw new Exception("The text hasn't been initialized yet!");
             ResetInfo();
-            await Execute();
+            await Execute(betweenEvents, cancellationToken).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// Parses lots of small records packed one after the other into <paramref name="buffer"/> - record "i" goes from <c>offsets[i]</c> up to <c>offsets[i + 1]</c>, so there's one more offset than there are records.
+        /// Each one is parsed as if it had been given to <see cref="SetText(string)"/> by itself (so positions are from the start of the record), but it's all done in one go, without setting up the text for each one.
+        /// <see cref="OnRecordEnd"/> is triggered at the end of every record, while <see cref="OnStart"/> and <see cref="OnEnd"/> are only triggered once, for the whole batch.
+        /// </summary>
+        public unsafe void StartBatch(string buffer, int[] offsets)
+        {
+            if (offsets.Length == 0 || offsets[0] < 0 || offsets[offsets.Length - 1] > buffer.Length) throw new ABParserInvalidBatchOffsets();
+            for (int i = 0; i < offsets.Length - 1; i++)
+                if (offsets[i + 1] < offsets[i]) throw new ABParserInvalidBatchOffsets();
+
+            _disposeTask.Wait();
+
+            _textAsString = buffer;
+            Text = buffer.ToCharArray();
+            TextLength = buffer.Length;
+            CurrentRecord = 0;
+            ResetInfo();
+
+            if (offsets.Length < 2)
+            {
+                OnStart();
+                OnEndArgs.Leading = new char[0];
+                OnEnd(OnEndArgs);
+                return;
+            }
+
+            int longest = 0;
+            for (int i = 0; i < offsets.Length - 1; i++)
+                longest = Math.Max(longest, offsets[i + 1] - offsets[i]);
+
+            if (_resultData == null || _resultData.Length < longest + 8)
+                _resultData = new ushort[longest + 8];
+
+            // The core reads straight out of the text, so it has to stay pinned until the batch is finished.
+            try
+            {
+                fixed (char* text = Text)
+                fixed (int* recordOffsets = offsets)
+                {
+                    if (!NativeMethods.BeginBatch(_baseParser, text, (uint)buffer.Length, (uint*)recordOffsets, (uint)(offsets.Length - 1)))
+                        throw new ABParserInvalidBatchOffsets();
+                    _batchOffsets = offsets;
+
+                    BeginExecution();
+                    while (ExecuteNext()) ;
+                }
+            }
+            finally
+            {
+                _batchOffsets = null;
+            }
+        }
+
+        /// <summary>
+        /// Starts a parse that's driven one event at a time by <see cref="ContinueParse"/>, instead of all in one go. This lets one thread interleave lots of parses, and leave any of them waiting for as long as it needs.
+        /// </summary>
+        public void BeginParse()
+        {
+            if (Text == null)
+                throw new Exception("The text hasn't been initialized yet!");
+            _disposeTask.Wait();
+            ResetInfo();
+            BeginExecution();
+        }
+
+        /// <summary>
+        /// Runs the parse started by <see cref="BeginParse"/> up to its next event (or until it yields, if <see cref="CharacterBudget"/> is set), and triggers it. Gives false once the parse has finished.
+        /// </summary>
+        public bool ContinueParse() => ExecuteNext();
+
+        /// <summary>
+        /// Stops the parse that's currently going part-way through, without <see cref="OnEnd"/>, so the parser can be used again.
+        /// </summary>
+        public void AbandonParse()
+        {
+            NativeMethods.ResetParseState(_baseParser);
+            _executionResult = ContinueExecutionResult.StopAndFinalOnTokenProcessed;
+
+            CurrentEventTokenLimits.Clear();
+            CurrentTriviaLimits.Clear();
+
+            _disposedForNextParse = false;
+            if (!_disposeAtDestruction)
+                DisposeDataForNextParse();
         }
 
         public void ChangeDisposeConfiguration(bool disposeAtDestruction, bool disposeAsyncronously)
@@ -357,6 +593,48 @@ public void ChangeDisposeConfiguration(bool disposeAtDestruction, bool disposeAs
 
         public string GetTextAsString() => _textAsString = new string(Text);
 
+        /// <summary>
+        /// Gets the counters the core has collected since it was created, or since <see cref="ResetStatistics"/> was last called.
+        /// </summary>
+        public ABParserStatistics GetStatistics()
+        {
+            NativeMethods.GetStatistics(_baseParser, out var statistics);
+            return statistics;
+        }
+
+        public void ResetStatistics() => NativeMethods.ResetStatistics(_baseParser);
+
+        #endregion
+
+        #region Subscriptions
+
+        /// <summary>
+        /// Sets whether any events are given for the token at "tokenIndex" (its index in <see cref="Tokens"/>) - they all are by default. A token that isn't subscribed to is still found like normal,
+        /// but then the parser just carries on past it, with its text either left in the trivia around it or taken out, depending on <see cref="UnsubscribedTokens"/>.
+        /// </summary>
+        public void SetTokenSubscribed(int tokenIndex, bool subscribed)
+        {
+            if (_subscribedTokens == null)
+            {
+                if (subscribed) return;
+
+                _subscribedTokens = new ulong[(Tokens.Length + 63) / 64];
+                for (int i = 0; i < _subscribedTokens.Length; i++)
+                    _subscribedTokens[i] = ulong.MaxValue;
+            }
+
+            if (subscribed) _subscribedTokens[tokenIndex >> 6] |= 1UL << (tokenIndex & 63);
+            else
+            {
+                if (Tokens[tokenIndex].HasLimitRules) throw new ABParserCannotUnsubscribe();
+                _subscribedTokens[tokenIndex >> 6] &= ~(1UL << (tokenIndex & 63));
+            }
+        }
+
+        public void SubscribeToAllTokens() => _subscribedTokens = null;
+
+        public bool IsTokenSubscribed(int tokenIndex) => _subscribedTokens == null || (_subscribedTokens[tokenIndex >> 6] & (1UL << (tokenIndex & 63))) != 0;
+
         #endregion
 
         #region Constructor / Dispose
@@ -364,8 +642,7 @@ public void ChangeDisposeConfiguration(bool disposeAtDestruction, bool disposeAs
         protected ABParser(ABParserConfiguration config) => InitializeABParser(config);
         public async void Dispose()
         {
-            while (_currentlyDisposing)
-                await Task.Delay(1);
+            await _disposeTask.ConfigureAwait(false);
             if (_disposeAtDestruction && !_disposedForNextParse)
                 DisposeDataForNextParse();
             NativeMethods.DeleteBaseParser(_baseParser);
@@ -35,20 +35,35 @@ public class ABParserConfiguration : IDisposable
 
         public unsafe ABParserConfiguration(ABParserToken[] tokens, int numberOfTriviaTokens = 0)
         {
-            if (tokens.Length > ushort.MaxValue) throw new ABParserTooManyTokens();
+            // Each token has four limit rule names (see "SetLimitRules"), which all need to fit in one array.
+            if (tokens.Length > int.MaxValue / 4) throw new ABParserTooManyTokens();
             Tokens = tokens;
 
+            // There can be far too many tokens for these to go on the stack.
             var tokenData = new string[tokens.Length];
-            var tokenDataLengths = stackalloc ushort[tokens.Length];
-            var limitsPerToken = stackalloc ushort[tokens.Length];
+            var tokenDataLengths = new ushort[tokens.Length];
+            var limitsPerToken = new ushort[tokens.Length];
             var limitNames = new List<string>();
             var tokenDetectionLimits = new string[tokens.Length];
-            var tokenDetectionSizes = stackalloc ushort[tokens.Length];
+            var tokenDetectionSizes = new ushort[tokens.Length];
+
+            // Only needed if there are any run tokens, the core treats these as all being normal tokens otherwise.
+            uint[] tokenRunLengths = null;
 
             for (int i = 0; i < tokens.Length; i++)
             {
-                tokenData[i] = tokens[i].Data;
-                tokenDataLengths[i] = (ushort)tokens[i].Data.Length;
+                if (tokens[i].RunRanges == null)
+                    tokenData[i] = tokens[i].Data;
+                else
+                {
+                    // A run token's data is its ranges, and its minimum length (which is never 0) marks it as a run.
+                    if (tokenRunLengths == null) tokenRunLengths = new uint[tokens.Length * 2];
+                    tokenData[i] = new string(tokens[i].RunRanges);
+                    tokenRunLengths[i * 2] = (uint)tokens[i].MinRunLength;
+                    tokenRunLengths[i * 2 + 1] = (uint)tokens[i].MaxRunLength;
+                }
+
+                tokenDataLengths[i] = (ushort)tokenData[i].Length;
 
                 if (tokens[i].TokenLimits == null)
                     limitsPerToken[i] = 0;
@@ -67,12 +82,66 @@ public unsafe ABParserConfiguration(ABParserToken[] tokens, int numberOfTriviaTo
                 }
             }
 
-            var limitNameSizes = stackalloc byte[limitNames.Count];
+            // This has to happen before anything's made on the C++ side, as nothing would free it if this threw.
+            ValidateLimitRules(limitNames, numberOfTriviaTokens);
+
+            var limitNameSizes = new byte[limitNames.Count];
             for (int i = 0; i < limitNames.Count; i++)
                 limitNameSizes[i] = (byte)limitNames[i].Length;
 
-            TokensStorage = NativeMethods.InitializeConfiguration(tokenData, tokenDataLengths, (ushort)tokens.Length, limitNames.ToArray(), limitNameSizes, limitsPerToken, tokenDetectionLimits, tokenDetectionSizes);
+            fixed (ushort* tokenDataLengthsPtr = tokenDataLengths)
+            fixed (ushort* limitsPerTokenPtr = limitsPerToken)
+            fixed (ushort* tokenDetectionSizesPtr = tokenDetectionSizes)
+            fixed (byte* limitNameSizesPtr = limitNameSizes)
+            fixed (uint* tokenRunLengthsPtr = tokenRunLengths)
+                TokensStorage = NativeMethods.InitializeConfiguration(tokenData, tokenDataLengthsPtr, (uint)tokens.Length, limitNames.ToArray(), limitNameSizesPtr, limitsPerTokenPtr, tokenDetectionLimits, tokenDetectionSizesPtr, tokenRunLengthsPtr);
             TriviaLimits = new ABParserConfigurationTriviaLimit[numberOfTriviaTokens];
+
+            SetLimitRules();
+        }
+
+        // The core ignores rules for limits that don't exist, so they're checked here instead, where it can be made clear something's wrong. The trivia limits are checked as they're added.
+        private void ValidateLimitRules(List<string> tokenLimitNames, int numberOfTriviaTokens)
+        {
+            for (int i = 0; i < Tokens.Length; i++)
+            {
+                if (!Tokens[i].HasLimitRules) continue;
+
+                if ((Tokens[i].EntersTokenLimit != null && !tokenLimitNames.Contains(Tokens[i].EntersTokenLimit)) ||
+                    (Tokens[i].ExitsTokenLimit != null && !tokenLimitNames.Contains(Tokens[i].ExitsTokenLimit)))
+                    throw new ABParserInvalidLimitName();
+
+                if (numberOfTriviaTokens == 0 && (Tokens[i].EntersTriviaLimit != null || Tokens[i].ExitsTriviaLimit != null))
+                    throw new ABParserInvalidLimitName();
+            }
+        }
+
+        private unsafe void SetLimitRules()
+        {
+            bool hasRules = false;
+
+            for (int i = 0; i < Tokens.Length; i++)
+                if (Tokens[i].HasLimitRules) hasRules = true;
+
+            if (!hasRules) return;
+
+            var ruleNames = new string[Tokens.Length * 4];
+            var ruleNameSizes = new byte[Tokens.Length * 4];
+
+            for (int i = 0; i < Tokens.Length; i++)
+            {
+                ruleNames[i * 4] = Tokens[i].EntersTokenLimit;
+                ruleNames[i * 4 + 1] = Tokens[i].ExitsTokenLimit;
+                ruleNames[i * 4 + 2] = Tokens[i].EntersTriviaLimit;
+                ruleNames[i * 4 + 3] = Tokens[i].ExitsTriviaLimit;
+
+                for (int j = i * 4; j < i * 4 + 4; j++)
+                    ruleNameSizes[j] = (byte)(ruleNames[j]?.Length ?? 0);
+            }
+
+            fixed (byte* ruleNameSizesPtr = ruleNameSizes)
+                if (!NativeMethods.ConfigSetLimitRules(TokensStorage, ruleNames, ruleNameSizesPtr))
+                    throw new ABParserConfigurationInUse();
         }
 
         public ABParserConfiguration AddTriviaLimit(bool isWhiteList, string name, params char[] toIgnore)
@@ -100,6 +169,11 @@ private unsafe void FlushTriviaLimits()
             var limitContentLengths = stackalloc ushort[TriviaLimits.Length];
 
             var limitIsWhitelist = stackalloc bool[TriviaLimits.Length];
+
+            for (int i = 0; i < Tokens.Length; i++)
+                if ((Tokens[i].EntersTriviaLimit != null && !HasTriviaLimit(Tokens[i].EntersTriviaLimit)) ||
+                    (Tokens[i].ExitsTriviaLimit != null && !HasTriviaLimit(Tokens[i].ExitsTriviaLimit)))
+                    throw new ABParserInvalidLimitName();
             
             for (int i = 0; i < TriviaLimits.Length; i++)
             {
@@ -112,7 +186,18 @@ private unsafe void FlushTriviaLimits()
                 limitIsWhitelist[i] = TriviaLimits[i].IsWhiteList;
             }
 
-            NativeMethods.ConfigSetTriviaLimits(TokensStorage, limitIsWhitelist, limitNames, limitLengths, limitContents, limitContentLengths, TriviaLimits.Length);
+            // Every parser using this configuration relies on it not changing, so all of the trivia limits need adding before any parsers are made with it.
+            if (!NativeMethods.ConfigSetTriviaLimits(TokensStorage, limitIsWhitelist, limitNames, limitLengths, limitContents, limitContentLengths, TriviaLimits.Length))
+                throw new ABParserConfigurationInUse();
+        }
+
+        bool HasTriviaLimit(string name)
+        {
+            for (int i = 0; i < TriviaLimits.Length; i++)
+                if (TriviaLimits[i].Name == name)
+                    return true;
+
+            return false;
         }
 
         public void Dispose()
@@ -0,0 +1,36 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace ABSoftware.ABParser
+{
+    /// <summary>
+    /// Counters showing what the core did while parsing. These are only collected when the core is compiled with "_ABP_COLLECT_STATS", otherwise they will all be zero.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ABParserStatistics
+    {
+        public ulong CharactersProcessed;
+
+        public ulong FutureTokensCreated;
+        public ulong FutureTokensDisabled;
+
+        public ulong VerifyTokensStarted;
+        public ulong VerifyTokensStopped;
+        public ulong VerifyTokensFinalized;
+
+        public ulong TriviaBytesCopied;
+
+        public ulong TokenLimitsEntered;
+        public ulong TokenLimitsExited;
+        public ulong TriviaLimitsEntered;
+        public ulong TriviaLimitsExited;
+
+        /// <summary>
+        /// The time spent in each phase of the core's execution, in nanoseconds.
+        /// </summary>
+        public ulong UpdateFutureTokensTime;
+        public ulong AddFutureTokensTime;
+        public ulong ProcessFinishedTokensTime;
+        public ulong FinalizeVerifyTokensTime;
+    }
+}
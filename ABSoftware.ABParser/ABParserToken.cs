@@ -12,6 +12,22 @@ public sealed class ABParserToken
         public string[] TokenLimits = null;
         public char[] DetectionLimits = null;
 
+        /// <summary>
+        /// The limits this token enters or exits by itself whenever it's found, so <see cref="ABParser.BeforeTokenProcessed"/> doesn't need to. An exit only happens if that limit is the current one,
+        /// and takes priority over entering - so a token that enters and exits the same limit (like a quote) toggles in and out of it.
+        /// </summary>
+        public string EntersTokenLimit = null;
+        public string ExitsTokenLimit = null;
+        public string EntersTriviaLimit = null;
+        public string ExitsTriviaLimit = null;
+
+        /// <summary>
+        /// If this isn't null, this is a run token (see <see cref="SetRun(int, int, char[])"/>), and these are the first and last character of each of its ranges.
+        /// </summary>
+        public char[] RunRanges = null;
+        public int MinRunLength = 1;
+        public int MaxRunLength = 0;
+
         /// <summary>
         /// The name this token can be given to identify it.
         /// </summary>
@@ -54,5 +70,54 @@ public ABParserToken SetDetectionLimits(params char[] detectionLimits)
             DetectionLimits = detectionLimits;
             return this;
         }
+
+        /// <summary>
+        /// Makes this token match a run of characters from the given ranges (given as pairs of the first and last character, e.g. '0', '9' for digits) instead of its data, so things like
+        /// numbers and identifiers can come through as tokens instead of being picked out of the trivia. A run is decided where it starts, as long as nothing else is in the middle of being
+        /// found - it takes priority over other tokens that start there, and nothing is looked for inside of it. A maximum length of 0 means there's no maximum, otherwise longer runs get split up.
+        /// </summary>
+        public ABParserToken SetRun(int minLength, int maxLength, params char[] ranges)
+        {
+            if (ranges.Length == 0 || ranges.Length % 2 != 0 || ranges.Length / 2 > ushort.MaxValue) throw new ABParserInvalidRun();
+            if (minLength < 1 || maxLength < 0 || (maxLength != 0 && maxLength < minLength)) throw new ABParserInvalidRun();
+
+            for (int i = 0; i < ranges.Length; i += 2)
+                if (ranges[i] > ranges[i + 1]) throw new ABParserInvalidRun();
+
+            RunRanges = ranges;
+            MinRunLength = minLength;
+            MaxRunLength = maxLength;
+            return this;
+        }
+
+        public ABParserToken SetEntersTokenLimit(string limitName)
+        {
+            if (limitName.Length > 255) throw new ABParserNameTooLong();
+            EntersTokenLimit = limitName;
+            return this;
+        }
+
+        public ABParserToken SetExitsTokenLimit(string limitName)
+        {
+            if (limitName.Length > 255) throw new ABParserNameTooLong();
+            ExitsTokenLimit = limitName;
+            return this;
+        }
+
+        public ABParserToken SetEntersTriviaLimit(string limitName)
+        {
+            if (limitName.Length > 255) throw new ABParserNameTooLong();
+            EntersTriviaLimit = limitName;
+            return this;
+        }
+
+        public ABParserToken SetExitsTriviaLimit(string limitName)
+        {
+            if (limitName.Length > 255) throw new ABParserNameTooLong();
+            ExitsTriviaLimit = limitName;
+            return this;
+        }
+
+        internal bool HasLimitRules => EntersTokenLimit != null || ExitsTokenLimit != null || EntersTriviaLimit != null || ExitsTriviaLimit != null;
     }
 }
@@ -0,0 +1,18 @@
+﻿namespace ABSoftware.ABParser
+{
+    /// <summary>
+    /// What happens to the text of a token the parser isn't subscribed to - see <see cref="ABParser.SetTokenSubscribed(int, bool)"/>.
+    /// </summary>
+    public enum ABParserUnsubscribedTokens
+    {
+        /// <summary>
+        /// It's left in the trivia around it, as if it wasn't a token at all.
+        /// </summary>
+        AsTrivia = 0,
+
+        /// <summary>
+        /// It's taken out, so it isn't in any trivia.
+        /// </summary>
+        Skip = 1
+    }
+}
@@ -10,6 +10,11 @@ public class OnTokenProcessedEventArgs : TokenProcessedEventArgs
     {
         public TokenInformation NextToken;
 
+        /// <summary>
+        /// Only false when the token's being given early (see <see cref="ABParser.EmitTokensEarly"/>) - there's no trailing or next token yet, they come later in "OnTrailingProcessed".
+        /// </summary>
+        public bool TrailingKnown { get; internal set; } = true;
+
         internal string TrailingAsString;
         public char[] Trailing { get; internal set; }
 
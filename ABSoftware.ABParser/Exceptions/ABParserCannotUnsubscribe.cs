@@ -0,0 +1,11 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace ABSoftware.ABParser.Exceptions
+{
+    public class ABParserCannotUnsubscribe : Exception
+    {
+        public ABParserCannotUnsubscribe() : base("Tokens with limit rules can't be unsubscribed from, as the limits they enter and exit wouldn't be reflected in \"CurrentEventTokenLimits\" and \"CurrentTriviaLimits\"!") { }
+    }
+}
@@ -0,0 +1,13 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Exceptions
+{
+    public class ABParserConfigurationInUse : Exception
+    {
+        public ABParserConfigurationInUse() : base("The configuration is already being used by a parser, so it can't be changed any more. All of the trivia limits need to be added before any parsers are made with it.") { }
+    }
+}
@@ -0,0 +1,13 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Exceptions
+{
+    public class ABParserInvalidBatchOffsets : Exception
+    {
+        public ABParserInvalidBatchOffsets() : base("The batch's offsets are invalid. There must be at least one, the first can't be negative, they can't go backwards, and the last can't be past the end of the buffer.") { }
+    }
+}
@@ -0,0 +1,13 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ABSoftware.ABParser.Exceptions
+{
+    public class ABParserInvalidRun : Exception
+    {
+        public ABParserInvalidRun() : base("The run given is invalid. The ranges must be pairs of the first and last character of each range (with the first not after the last), the minimum length must be at least 1, and the maximum length must be 0 (no maximum) or at least the minimum length.") { }
+    }
+}
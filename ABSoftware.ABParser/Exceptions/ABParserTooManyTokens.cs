@@ -8,6 +8,6 @@ namespace ABSoftware.ABParser.Exceptions
 {
     public class ABParserTooManyTokens : Exception
     {
-        public ABParserTooManyTokens() : base("There are too many tokens, ABParser can only have up to 65,535 tokens, consider making two parsers instead.") { }
+        public ABParserTooManyTokens() : base("There are too many tokens, ABParser can only have up to 536,870,911 tokens, consider making two parsers instead.") { }
     }
 }
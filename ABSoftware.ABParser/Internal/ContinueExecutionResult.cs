@@ -12,6 +12,7 @@ public enum ContinueExecutionResult
         StopAndFinalOnTokenProcessed = 1,
         FirstBeforeTokenProcessed = 2,
         OnThenBeforeTokenProcessed = 3,
-        OnFirstUnlimitedCharacterProcessed = 4
+        OnFirstUnlimitedCharacterProcessed = 4,
+        Yielded = 5
     }
 }
@@ -14,7 +14,7 @@ internal static class NativeMethods
         internal const CallingConvention CALLING_CONVENTION = CallingConvention.Cdecl;
 
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
-        internal static unsafe extern IntPtr InitializeConfiguration(string[] tokensData, ushort* tokenLengths, ushort numberOfTokens, string[] limitNames, byte* limitNameSizes, ushort* limitsPerToken, string[] limitDetectionLimits, ushort* limitDetectionLimitSizes);
+        internal static unsafe extern IntPtr InitializeConfiguration(string[] tokensData, ushort* tokenLengths, uint numberOfTokens, string[] limitNames, byte* limitNameSizes, ushort* limitsPerToken, string[] limitDetectionLimits, ushort* limitDetectionLimitSizes, uint* tokenRunLengths);
 
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static extern IntPtr CreateBaseParser(IntPtr tokenData);
@@ -23,7 +23,10 @@ internal static class NativeMethods
         internal static unsafe extern ContinueExecutionResult ContinueExecution(IntPtr parser, ushort* outData);
 
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
-        internal static unsafe extern void ConfigSetTriviaLimits(IntPtr config, bool* limitsAreWhitelist, string[] limitNames, byte* limitNameSizes, string[] limitContents, ushort* limitContentLengths, int numberOfLimits);
+        internal static unsafe extern bool ConfigSetTriviaLimits(IntPtr config, bool* limitsAreWhitelist, string[] limitNames, byte* limitNameSizes, string[] limitContents, ushort* limitContentLengths, int numberOfLimits);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static unsafe extern bool ConfigSetLimitRules(IntPtr config, string[] ruleNames, byte* ruleNameSizes);
 
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static unsafe extern void InitString(IntPtr parser, char* text, int textLength);
@@ -31,6 +34,12 @@ internal static class NativeMethods
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static unsafe extern void InitString(IntPtr parser, string text, int textLength);
 
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static unsafe extern bool BeginBatch(IntPtr parser, char* buffer, uint bufferLength, uint* offsets, uint numberOfRecords);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static unsafe extern ContinueExecutionResult ContinueBatchExecution(IntPtr parser, ushort* outData);
+
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static extern void DisposeDataForNextParse(IntPtr parser);
 
@@ -46,10 +55,25 @@ internal static class NativeMethods
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static extern void ExitTriviaLimit(IntPtr baseParser, int levels);
 
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static unsafe extern void SetTokenSubscriptions(IntPtr baseParser, ulong* mask, uint maskLength, ABParserUnsubscribedTokens unsubscribedTokens);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static extern void SetCharacterBudget(IntPtr baseParser, uint characterBudget);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static extern void ResetParseState(IntPtr baseParser);
+
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static extern void DeleteBaseParser(IntPtr baseParser);
 
         [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
         internal static extern void DeleteConfiguration(IntPtr configuration);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static extern void GetStatistics(IntPtr baseParser, out ABParserStatistics statistics);
+
+        [DllImport(COREDLL, CharSet = CHARSET, CallingConvention = CALLING_CONVENTION)]
+        internal static extern void ResetStatistics(IntPtr baseParser);
     }
 }
\ No newline at end of file